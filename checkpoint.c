@@ -0,0 +1,327 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the defined functions declared in the checkpoint.h header file.
+	A checkpoint is written at the end of a tick, so a run restored from it goes
+	on exactly as the saved run did from the next tick:
+
+		scheduler -g rate=0.003 -o tick_limit=5000000 -K 5000000 -k warm.ckpt
+		scheduler -R warm.ckpt -o tick_limit=6000000 -o reset_count=60
+
+	Settings given with -c, -o and -g when restoring go on top of the saved
+	config. Totals start again at the restored tick, so warm-up does not count
+	towards them. A run replaying a workload given with -r needs the same -r
+	when restored.
+*/
+
+#include "checkpoint.h"
+#include "scheduler.h"
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+const char * checkpointPath = NULL; // a checkpoint is written here at checkpointTick when set
+unsigned int checkpointTick = 0;
+Checkpoint restoreFrom = NULL; // osLoop resumes from here instead of starting fresh when set
+
+
+/* Where tablePCB appends the next PCB. */
+typedef struct table_cursor {
+	PCB * table;
+	unsigned int count;
+} TableCursor_s;
+
+
+/*
+	Appends the PCB to the cursor's table.
+*/
+void tablePCBAppend (PCB pcb, void * arg) {
+	TableCursor_s * cursor = arg;
+	cursor->table[cursor->count++] = pcb;
+}
+
+
+/*
+	Appends every PCB in the queue to the table, in queue order.
+*/
+void tableQueue (ReadyQueue queue, PCB * table, unsigned int * count) {
+	TableCursor_s cursor = {table, *count};
+	q_visit(queue, tablePCBAppend, &cursor);
+	*count = cursor.count;
+}
+
+
+/*
+	Returns the index of the PCB in the table, or CHECKPOINT_NONE if it is NULL
+	or not there.
+*/
+int findPCB (PCB * table, unsigned int count, PCB pcb) {
+	if (pcb != NULL) {
+		for (unsigned int i = 0; i < count; i++) {
+			if (table[i] == pcb) {
+				return i;
+			}
+		}
+	}
+	return CHECKPOINT_NONE;
+}
+
+
+/*
+	Returns the PCB at the index in the table, or NULL for CHECKPOINT_NONE.
+*/
+PCB tablePCB (PCB * table, unsigned int count, int index) {
+	return (index >= 0 && (unsigned int) index < count) ? table[index] : NULL;
+}
+
+
+/*
+	Writes the state of the run, with osLoop's counters, to path. The file is
+	written beside path and renamed over it, so a crash mid-write never leaves a
+	half written checkpoint behind. Returns 1 on success, 0 otherwise.
+*/
+int checkpointSave (const char * path, Scheduler theScheduler, int totalProcesses, int iterationCount) {
+	char tmpPath[PATH_MAX + sizeof ".tmp"]; // room for ".tmp" after any path
+	CheckpointHeader_s * header;
+	CheckpointPCB_s * pcbs;
+	ReadyQueue queues[CHECKPOINT_QUEUES];
+	unsigned int total = 0, count = 0;
+	unsigned long long size;
+	unsigned char * map;
+	PCB * table;
+	int fd;
+
+	if (snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path) >= (int) sizeof(tmpPath)) {
+		return 0; // cut short, it could name the checkpoint itself or another file
+	}
+	queues[0] = theScheduler->created;
+	queues[1] = theScheduler->blocked;
+	queues[2] = theScheduler->killed;
+	for (int i = 0; i < NUM_PRIORITIES; i++) {
+		queues[3 + i] = theScheduler->ready->queues[i];
+	}
+	for (int i = 0; i < CHECKPOINT_QUEUES; i++) {
+		total += queues[i]->size;
+	}
+	total += theScheduler->running != NULL;
+	table = malloc((total + 1) * sizeof(PCB));
+	if (table == NULL) {
+		return 0;
+	}
+	for (int i = 0; i < CHECKPOINT_QUEUES; i++) {
+		tableQueue(queues[i], table, &count);
+	}
+	if (theScheduler->running != NULL) {
+		table[count++] = theScheduler->running;
+	}
+
+	size = sizeof(CheckpointHeader_s) + (unsigned long long) count * sizeof(CheckpointPCB_s);
+	fd = open(tmpPath, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0 || ftruncate(fd, size) != 0) {
+		if (fd >= 0) {
+			close(fd);
+		}
+		free(table);
+		return 0;
+	}
+	map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (map == MAP_FAILED) {
+		close(fd);
+		free(table);
+		return 0;
+	}
+
+	header = (CheckpointHeader_s *) map;
+	header->magic = CHECKPOINT_MAGIC;
+	header->version = CHECKPOINT_VERSION;
+	header->header_size = sizeof(CheckpointHeader_s);
+	header->pcb_size = sizeof(CheckpointPCB_s);
+	header->pcb_count = count;
+	for (int i = 0; i < CHECKPOINT_QUEUES; i++) {
+		header->queue_lengths[i] = queues[i]->size;
+	}
+	header->levels = theScheduler->ready->levels;
+	header->running = findPCB(table, count, theScheduler->running);
+	header->interrupted = findPCB(table, count, theScheduler->interrupted);
+	header->sysstack_owner = findPCB(table, count, sysstackOwner);
+	for (int i = 0; i < CHECKPOINT_PRIVILEGED; i++) {
+		header->privileged[i] = findPCB(table, count, privileged[i]);
+	}
+	header->is_new = theScheduler->isNew;
+	header->sim_tick = sim_tick;
+	header->sysstack = sysstack;
+	header->io_timer = io_timer;
+	header->io_pending = ioPending;
+	header->io_pending_since = ioPendingSince;
+	header->io_pending_ticks = ioPendingTicks;
+	header->quantum_size = currQuantumSize;
+	header->live_terminating = liveTerminating;
+	header->largest_pid = global_largest_PID;
+	header->total_processes = totalProcesses;
+	header->iteration_count = iterationCount;
+	header->replay_next = replay != NULL ? replay->next : 0;
+	header->rng_state = rngState();
+	header->rng_arrival_state = rngArrivalState();
+	header->config = baseConfig;
+	header->generator = config.generator;
+	memcpy(header->adapt, adaptLevels, sizeof(adaptLevels));
+
+	pcbs = (CheckpointPCB_s *) (map + sizeof(CheckpointHeader_s));
+	for (unsigned int i = 0; i < count; i++) {
+		pcbs[i].pcb = *table[i];
+		pcbs[i].pcb.mem = NULL;
+		pcbs[i].pcb.context = NULL;
+		pcbs[i].context = *table[i]->context;
+	}
+	free(table);
+
+	if (msync(map, size, MS_SYNC) != 0) {
+		munmap(map, size);
+		close(fd);
+		return 0;
+	}
+	munmap(map, size);
+	close(fd);
+	return rename(tmpPath, path) == 0;
+}
+
+
+/*
+	Maps the checkpoint at path and checks that it was written by this build.
+	Returns NULL if it can not be opened or does not fit.
+*/
+Checkpoint checkpointOpen (const char * path) {
+	struct stat info;
+	CheckpointHeader_s * header;
+	unsigned long long queued = 0;
+	Checkpoint checkpoint = malloc(sizeof(Checkpoint_s));
+	if (checkpoint == NULL) {
+		return NULL;
+	}
+	checkpoint->fd = open(path, O_RDONLY);
+	if (checkpoint->fd < 0 || fstat(checkpoint->fd, &info) != 0
+			|| info.st_size < (off_t) sizeof(CheckpointHeader_s)) {
+		if (checkpoint->fd >= 0) {
+			close(checkpoint->fd);
+		}
+		free(checkpoint);
+		return NULL;
+	}
+	checkpoint->map_size = info.st_size;
+	checkpoint->map = mmap(NULL, checkpoint->map_size, PROT_READ, MAP_PRIVATE, checkpoint->fd, 0);
+	if (checkpoint->map == MAP_FAILED) {
+		close(checkpoint->fd);
+		free(checkpoint);
+		return NULL;
+	}
+
+	header = (CheckpointHeader_s *) checkpoint->map;
+	checkpoint->header = header;
+	checkpoint->pcbs = (CheckpointPCB_s *) (checkpoint->map + sizeof(CheckpointHeader_s));
+	for (int i = 0; i < CHECKPOINT_QUEUES; i++) {
+		queued += header->queue_lengths[i];
+	}
+	if (header->magic != CHECKPOINT_MAGIC || header->version != CHECKPOINT_VERSION
+			|| header->header_size != sizeof(CheckpointHeader_s) || header->pcb_size != sizeof(CheckpointPCB_s)
+			|| checkpoint->map_size < sizeof(CheckpointHeader_s) + (unsigned long long) header->pcb_count * sizeof(CheckpointPCB_s)
+			|| queued > header->pcb_count || header->levels < 1 || header->levels > NUM_PRIORITIES) {
+		checkpointClose(checkpoint);
+		return NULL;
+	}
+	return checkpoint;
+}
+
+
+/*
+	Unmaps and closes the given checkpoint.
+*/
+void checkpointClose (Checkpoint checkpoint) {
+	munmap(checkpoint->map, checkpoint->map_size);
+	close(checkpoint->fd);
+	free(checkpoint);
+}
+
+
+/*
+	Rebuilds the Scheduler, its PCBs and every global saved in the checkpoint,
+	and hands back osLoop's counters. The config must already be finished; the
+	MLFQ is moved onto its levels and quanta once the saved queues are filled.
+	Returns NULL if the PCBs could not be allocated.
+*/
+Scheduler checkpointRestore (Checkpoint checkpoint, int * totalProcesses, int * iterationCount) {
+	CheckpointHeader_s * header = checkpoint->header;
+	unsigned int count = header->pcb_count, next = 0;
+	ReadyQueue queues[CHECKPOINT_QUEUES];
+	Scheduler theScheduler;
+	PCB * table = malloc((count + 1) * sizeof(PCB));
+	if (table == NULL) {
+		return NULL;
+	}
+	for (unsigned int i = 0; i < count; i++) {
+		table[i] = malloc(sizeof(PCB_s));
+		if (table[i] != NULL) {
+			*table[i] = checkpoint->pcbs[i].pcb;
+			table[i]->context = malloc(sizeof(CPU_context_s));
+		}
+		if (table[i] == NULL || table[i]->context == NULL) {
+			free(table[i]);
+			while (i-- > 0) {
+				PCB_destroy(table[i]);
+			}
+			free(table);
+			return NULL;
+		}
+		*table[i]->context = checkpoint->pcbs[i].context;
+	}
+
+	theScheduler = schedulerConstructor();
+	pq_set_levels(theScheduler->ready, header->levels);
+	queues[0] = theScheduler->created;
+	queues[1] = theScheduler->blocked;
+	queues[2] = theScheduler->killed;
+	for (int i = 0; i < NUM_PRIORITIES; i++) {
+		queues[3 + i] = theScheduler->ready->queues[i];
+	}
+	for (int i = 0; i < CHECKPOINT_QUEUES; i++) {
+		q_enqueue_batch(queues[i], table + next, header->queue_lengths[i]);
+		next += header->queue_lengths[i];
+	}
+	theScheduler->running = tablePCB(table, count, header->running);
+	theScheduler->interrupted = tablePCB(table, count, header->interrupted);
+	theScheduler->isNew = header->is_new;
+	memcpy(adaptLevels, header->adapt, sizeof(adaptLevels));
+	sim_tick = header->sim_tick; // before configureScheduler, which stamps PCBs it moves
+	configureScheduler(theScheduler);
+
+	sysstackOwner = tablePCB(table, count, header->sysstack_owner);
+	for (int i = 0; i < CHECKPOINT_PRIVILEGED; i++) {
+		privileged[i] = tablePCB(table, count, header->privileged[i]);
+	}
+	sysstack = header->sysstack;
+	io_timer = header->io_timer;
+	ioPending = header->io_pending;
+	ioPendingSince = header->io_pending_since;
+	ioPendingTicks = header->io_pending_ticks;
+	currQuantumSize = header->quantum_size;
+	liveTerminating = header->live_terminating;
+	global_largest_PID = header->largest_pid;
+	*totalProcesses = header->total_processes;
+	*iterationCount = header->iteration_count;
+	if (replay != NULL) {
+		workloadSeek(replay, header->replay_next);
+	}
+	rngSetState(header->rng_state);
+	rngSetArrivalState(header->rng_arrival_state);
+	config.generator.mmpp_state = header->generator.mmpp_state;
+	config.generator.state_end = header->generator.state_end;
+	config.generator.next_time = header->generator.next_time;
+
+	memset(&runStats, 0, sizeof(runStats));
+	runStats.start_tick = sim_tick;
+	switchCalls = 0;
+	free(table);
+	return theScheduler;
+}
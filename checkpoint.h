@@ -0,0 +1,94 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the definitions of structs and declarations of functions for the
+	checkpoint.c file. A checkpoint file holds the whole state of a run at the
+	end of a tick: a header with the globals, the RNG, the generator and the
+	config, followed by every PCB in queue order. PCBs refer to each other by
+	their place in the file instead of by pointer, so the file can be mapped
+	anywhere. Like workload files, it is written in the host's byte order.
+*/
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+//includes
+#include "config.h"
+#include "quantum_adapt.h"
+
+
+//defines
+#define CHECKPOINT_MAGIC 0x54504B43
+#define CHECKPOINT_VERSION 9
+#define CHECKPOINT_QUEUES (3 + NUM_PRIORITIES) // created, blocked, killed, then each MLFQ level
+#define CHECKPOINT_NONE -1 // a PCB reference that points at nothing
+#define CHECKPOINT_PRIVILEGED 4
+
+
+//structs
+/* A PCB with its pointers cleared and its context stored beside it. */
+typedef struct checkpoint_pcb {
+	PCB_s pcb;
+	CPU_context_s context;
+} CheckpointPCB_s;
+
+typedef struct checkpoint_header {
+	unsigned int magic;
+	unsigned int version;
+	unsigned int header_size;
+	unsigned int pcb_size;
+	unsigned int pcb_count;
+	unsigned int queue_lengths[CHECKPOINT_QUEUES];
+	int levels; // MLFQ levels the ready queues were saved with
+	int running; // PCB references, as indices into the PCBs
+	int interrupted;
+	int sysstack_owner;
+	int privileged[CHECKPOINT_PRIVILEGED];
+	int is_new;
+	unsigned int sim_tick;
+	unsigned int sysstack;
+	int io_timer;
+	int io_pending; // completions waiting for a coalesced I/O interrupt
+	unsigned int io_pending_since;
+	unsigned long long io_pending_ticks;
+	int quantum_size;
+	int live_terminating;
+	int largest_pid;
+	int total_processes; // osLoop's own counters
+	int iteration_count;
+	unsigned long long replay_next; // next record of the replayed workload
+	unsigned long long rng_state;
+	unsigned long long rng_arrival_state;
+	SchedConfig_s config; // as given, before configFinish
+	Generator_s generator; // with its place in time
+	AdaptLevel_s adapt[NUM_PRIORITIES]; // the bursts and quanta of adaptive_quantum
+} CheckpointHeader_s;
+
+typedef struct checkpoint {
+	int fd;
+	unsigned char * map;
+	unsigned long long map_size;
+	CheckpointHeader_s * header;
+	CheckpointPCB_s * pcbs;
+} Checkpoint_s;
+
+typedef Checkpoint_s * Checkpoint;
+
+
+//declarations
+extern const char * checkpointPath;
+extern unsigned int checkpointTick;
+extern Checkpoint restoreFrom;
+
+struct scheduler; // scheduler.h includes this file
+
+int checkpointSave (const char *, struct scheduler *, int, int);
+
+Checkpoint checkpointOpen (const char *);
+
+void checkpointClose (Checkpoint);
+
+struct scheduler * checkpointRestore (Checkpoint, int *, int *);
+
+#endif
@@ -0,0 +1,403 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the defined functions declared in the config.h header file.
+
+	An example config file:
+
+		# a 4 level MLFQ with quanta of 50, 100, 200 and 400 ticks
+		levels = 4
+		quantum = 50,100,200,400
+		demote.3 = 3        # the last level keeps its PCBs instead of wrapping to 0
+		promote.2 = 1       # PCBs waking from I/O at level 2 move up one level
+		reset_count = 30
+		adaptive_quantum = 1   # the quanta above are where each level starts from
+		adapt_target = 90      # and then follow the length 90% of its CPU bursts fit in
+		aging = 1           # or instead of resets, PCBs move up a level once they
+		age = 1,1000,1000,2000  # have waited at it this long
+		io_coalesce_count = 4  # one I/O interrupt wakes up to 4 PCBs...
+		io_coalesce_ticks = 10 # ...as long as none has waited 10 ticks
+		green_workers = 2   # the green thread runtime runs on 2 pthreads, with
+		green_tick_us = 20  # its quanta in ticks of 20us
+		gen.arrival = mmpp  # any generatorSet setting, which turns the generator on
+
+	Instead of listing every quantum, "ladder.base = 50" and "ladder.mult = 2"
+	give 50, 100, 200, ... and "workload" swaps the whole arrival source, either
+	for generator settings ("workload = size=pareto,alpha=1.2") or for a recorded
+	workload ("workload = replay:trace.wl"). "queue = ring" keeps every queue of
+	the Scheduler in a ring buffer instead of a linked list.
+*/
+
+#include "config.h"
+#include "scheduler.h"
+#include <ctype.h>
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#define LEVEL_UNSET 0xFF
+
+
+SchedConfig_s config;
+SchedConfig_s baseConfig; // config as it was given, before configFinish filled it in
+
+
+/*
+	Sets every setting to the compile time default. The per-level tables are left
+	unset and filled in by configFinish, because their defaults depend on how
+	many levels end up in use.
+*/
+void configDefaults (SchedConfig cfg) {
+	memset(cfg, 0, sizeof(SchedConfig_s));
+	cfg->levels = DEFAULT_PRIORITIES;
+	cfg->ladder_mult = CONFIG_LADDER_MULT;
+	memset(cfg->demote, LEVEL_UNSET, sizeof(cfg->demote));
+	memset(cfg->promote, LEVEL_UNSET, sizeof(cfg->promote));
+	cfg->reset_count = RESET_COUNT;
+	cfg->aging = AGING;
+	cfg->timer_range = TIMER_RANGE;
+	cfg->total_terminated = TOTAL_TERMINATED;
+	cfg->max_pcb_total = MAX_PCB_TOTAL;
+	cfg->quantum_carry_over = QUANTUM_CARRY_OVER;
+	cfg->adaptive_quantum = ADAPTIVE_QUANTUM;
+	cfg->adapt_target = ADAPT_TARGET;
+	cfg->io_coalesce_count = IO_COALESCE_COUNT;
+	cfg->io_coalesce_ticks = IO_COALESCE_TICKS;
+	cfg->tickless_idle = TICKLESS_IDLE;
+	cfg->green_workers = GREEN_WORKERS;
+	cfg->green_tick_us = GREEN_TICK_US;
+	cfg->green_reset = GREEN_RESET;
+	cfg->metrics_interval = METRICS_INTERVAL;
+	strcpy(cfg->metrics_file, METRICS_FILE);
+	generatorInit(&cfg->generator);
+}
+
+
+/*
+	Reads a level number out of the end of a key such as "quantum.3". Returns -1
+	if it is not a valid level.
+*/
+int keyLevel (const char * key, const char * prefix) {
+	int level;
+	char * end;
+	size_t length = strlen(prefix);
+	if (strncmp(key, prefix, length) != 0 || key[length] == '\0') {
+		return -1;
+	}
+	level = strtol(key + length, &end, 10);
+	if (*end != '\0' || level < 0 || level >= NUM_PRIORITIES) {
+		return -1;
+	}
+	return level;
+}
+
+
+/*
+	Reads a whole non-negative number. Returns 1 if the value is one, 0 otherwise.
+*/
+int parseCount (const char * value, unsigned long long * number) {
+	char * end;
+	if (!isdigit((unsigned char) *value)) {
+		return 0;
+	}
+	*number = strtoull(value, &end, 10);
+	return *end == '\0';
+}
+
+
+/*
+	Reads a comma separated list of positive numbers into table, from level 0
+	on. Returns 1 if there is at least one and all of them are valid, 0
+	otherwise.
+*/
+int parseLevelList (const char * value, unsigned int * table) {
+	char buffer[CONFIG_MAX_LINE];
+	char * item, * rest;
+	unsigned long long number;
+	int level = 0;
+	if (strlen(value) >= sizeof(buffer)) {
+		return 0;
+	}
+	strcpy(buffer, value);
+	for (item = strtok_r(buffer, ",", &rest); item != NULL; item = strtok_r(NULL, ",", &rest)) {
+		if (level >= NUM_PRIORITIES || !parseCount(item, &number) || number == 0 || number > UINT_MAX) {
+			return 0;
+		}
+		table[level++] = number;
+	}
+	return level > 0;
+}
+
+
+/*
+	Sets one setting by name. Returns 1 if the name and value are valid, 0
+	otherwise. Anything starting with "gen." is handed to generatorSet and turns
+	the generator on.
+*/
+int configSet (SchedConfig cfg, const char * key, const char * value) {
+	unsigned long long number = 0;
+	int level, isCount = parseCount(value, &number);
+
+	if (strncmp(key, "gen.", 4) == 0) {
+		cfg->use_generator = 1;
+		return generatorSet(&cfg->generator, key + 4, value);
+	}
+	if (strcmp(key, "workload") == 0) {
+		size_t prefix = strlen(CONFIG_REPLAY_PREFIX);
+		if (strncmp(value, CONFIG_REPLAY_PREFIX, prefix) == 0) {
+			if (strlen(value + prefix) == 0 || strlen(value + prefix) >= CONFIG_PATH_LENGTH) {
+				return 0;
+			}
+			strcpy(cfg->replay_file, value + prefix);
+			cfg->use_generator = 0;
+			return 1;
+		}
+		cfg->replay_file[0] = '\0';
+		cfg->use_generator = 1;
+		generatorInit(&cfg->generator);
+		return generatorParse(&cfg->generator, value);
+	}
+	if (strcmp(key, "queue") == 0) {
+		if (strcmp(value, "list") == 0) {
+			cfg->queue_kind = Q_LIST;
+		} else if (strcmp(value, "ring") == 0) {
+			cfg->queue_kind = Q_RING;
+		} else {
+			return 0;
+		}
+		return 1;
+	}
+	if (strcmp(key, "ladder.mult") == 0) {
+		char * end;
+		double mult = strtod(value, &end);
+		if (*end != '\0' || !(mult >= 1.0)) {
+			return 0;
+		}
+		cfg->ladder_mult = mult;
+		return 1;
+	}
+	if (strcmp(key, "metrics_file") == 0) {
+		if (strlen(value) >= CONFIG_PATH_LENGTH) {
+			return 0;
+		}
+		strcpy(cfg->metrics_file, value);
+		return 1;
+	}
+	if (strcmp(key, "quantum") == 0) {
+		return parseLevelList(value, cfg->quantum);
+	}
+	if (strcmp(key, "age") == 0) {
+		return parseLevelList(value, cfg->age);
+	}
+	if (!isCount) {
+		return 0;
+	}
+	if ((level = keyLevel(key, "quantum.")) >= 0 && number > 0 && number <= UINT_MAX) {
+		cfg->quantum[level] = number;
+	} else if ((level = keyLevel(key, "age.")) >= 0 && number > 0 && number <= UINT_MAX) {
+		cfg->age[level] = number;
+	} else if ((level = keyLevel(key, "demote.")) >= 0 && number < NUM_PRIORITIES) {
+		cfg->demote[level] = number;
+	} else if ((level = keyLevel(key, "promote.")) >= 0 && number < NUM_PRIORITIES) {
+		cfg->promote[level] = number;
+	} else if (strcmp(key, "ladder.base") == 0 && number > 0 && number <= UINT_MAX) {
+		cfg->ladder_base = number;
+	} else if (strcmp(key, "levels") == 0 && number >= 1 && number <= NUM_PRIORITIES) {
+		cfg->levels = number;
+	} else if (strcmp(key, "reset_count") == 0 && number >= 1 && number <= INT_MAX) {
+		cfg->reset_count = number;
+	} else if (strcmp(key, "aging") == 0 && number <= 1) {
+		cfg->aging = number;
+	} else if (strcmp(key, "timer_range") == 0 && number >= 1 && number <= INT_MAX) {
+		cfg->timer_range = number;
+	} else if (strcmp(key, "total_terminated") == 0 && number >= 1 && number <= INT_MAX) {
+		cfg->total_terminated = number;
+	} else if (strcmp(key, "max_pcb_total") == 0 && number >= 1 && number <= INT_MAX) {
+		cfg->max_pcb_total = number;
+	} else if (strcmp(key, "quantum_carry_over") == 0 && number <= 1) {
+		cfg->quantum_carry_over = number;
+	} else if (strcmp(key, "adaptive_quantum") == 0 && number <= 1) {
+		cfg->adaptive_quantum = number;
+	} else if (strcmp(key, "adapt_target") == 0 && number >= 1 && number <= 99) {
+		cfg->adapt_target = number;
+	} else if (strcmp(key, "io_coalesce_count") == 0 && number >= 1 && number <= INT_MAX) {
+		cfg->io_coalesce_count = number;
+	} else if (strcmp(key, "io_coalesce_ticks") == 0 && number <= UINT_MAX) {
+		cfg->io_coalesce_ticks = number;
+	} else if (strcmp(key, "tickless_idle") == 0 && number <= 1) {
+		cfg->tickless_idle = number;
+	} else if (strcmp(key, "green_workers") == 0 && number >= 1 && number <= GREEN_MAX_WORKERS) {
+		cfg->green_workers = number;
+	} else if (strcmp(key, "green_tick_us") == 0 && number >= 1 && number <= 1000000) {
+		cfg->green_tick_us = number;
+	} else if (strcmp(key, "green_reset") == 0 && number <= UINT_MAX) {
+		cfg->green_reset = number;
+	} else if (strcmp(key, "metrics_interval") == 0 && number >= 1 && number <= UINT_MAX) {
+		cfg->metrics_interval = number;
+	} else if (strcmp(key, "tick_limit") == 0 && number <= UINT_MAX) {
+		cfg->tick_limit = number;
+	} else if (strcmp(key, "seed") == 0) {
+		cfg->seed = number;
+	} else {
+		return 0;
+	}
+	return 1;
+}
+
+
+/*
+	Removes the whitespace from both ends of the string, in place.
+*/
+char * trim (char * str) {
+	char * end;
+	while (isspace((unsigned char) *str)) {
+		str++;
+	}
+	end = str + strlen(str);
+	while (end > str && isspace((unsigned char) end[-1])) {
+		end--;
+	}
+	*end = '\0';
+	return str;
+}
+
+
+/*
+	Sets one setting from a "key=value" string, as given on the command line.
+	Returns 1 on success, 0 otherwise.
+*/
+int configSetPair (SchedConfig cfg, const char * pair) {
+	char buffer[CONFIG_MAX_LINE];
+	char * value;
+	if (strlen(pair) >= sizeof(buffer)) {
+		return 0;
+	}
+	strcpy(buffer, pair);
+	value = strchr(buffer, '=');
+	if (value == NULL) {
+		return 0;
+	}
+	*value++ = '\0';
+	return configSet(cfg, trim(buffer), trim(value));
+}
+
+
+/*
+	Loads every setting in the given file. Blank lines and anything after a '#'
+	are ignored. Returns 1 on success, 0 if the file could not be read or has a
+	bad setting, which is reported with its line number.
+*/
+int configLoad (SchedConfig cfg, const char * path) {
+	char line[CONFIG_MAX_LINE];
+	char * comment, * setting;
+	int lineNumber = 0;
+	FILE * in = fopen(path, "r");
+	if (in == NULL) {
+		fprintf(stderr, "Could not open config %s\r\n", path);
+		return 0;
+	}
+	while (fgets(line, sizeof(line), in) != NULL) {
+		lineNumber++;
+		comment = strchr(line, '#');
+		if (comment != NULL) {
+			*comment = '\0';
+		}
+		setting = trim(line);
+		if (*setting != '\0' && !configSetPair(cfg, setting)) {
+			fprintf(stderr, "%s:%d: bad setting \"%s\"\r\n", path, lineNumber, setting);
+			fclose(in);
+			return 0;
+		}
+	}
+	fclose(in);
+	return 1;
+}
+
+
+/*
+	Fills in every per-level setting that was not given and checks the tables
+	against the number of levels. Unset quanta follow ladder.base and ladder.mult
+	if a base was given and the original ladder (500, then 1000 per level)
+	otherwise, an expired quantum moves a PCB down one level, wrapping
+	from the last level back to 0, completing I/O keeps a PCB at its level, and
+	aging moves a PCB up after AGING_AGE ticks. A generator in use is checked to
+	make arrivals at all.
+	Returns 1 if the config is usable, 0 otherwise.
+*/
+int configFinish (SchedConfig cfg) {
+	for (int i = 0; i < NUM_PRIORITIES; i++) {
+		if (cfg->quantum[i] == 0 && cfg->ladder_base) {
+			double quantum = cfg->ladder_base * pow(cfg->ladder_mult, i);
+			cfg->quantum[i] = quantum < UINT_MAX ? quantum : UINT_MAX;
+		} else if (cfg->quantum[i] == 0) {
+			cfg->quantum[i] = i ? i * PRIORITY_JUMP_EXTRA : MIN_PRIORITY_JUMP;
+		}
+		if (cfg->age[i] == 0) {
+			cfg->age[i] = AGING_AGE;
+		}
+		if (cfg->demote[i] == LEVEL_UNSET) {
+			cfg->demote[i] = i + 1 < cfg->levels ? i + 1 : 0;
+		}
+		if (cfg->promote[i] == LEVEL_UNSET) {
+			cfg->promote[i] = i < cfg->levels ? i : cfg->levels - 1;
+		}
+		if (i < cfg->levels && (cfg->demote[i] >= cfg->levels || cfg->promote[i] >= cfg->levels)) {
+			fprintf(stderr, "Level %d moves PCBs past the last level %d\r\n", i, cfg->levels - 1);
+			return 0;
+		}
+	}
+	if (cfg->use_generator && !generatorCheck(&cfg->generator)) {
+		return 0;
+	}
+	return 1;
+}
+
+
+/*
+	Writes the config out in the same format configLoad reads.
+*/
+void configPrint (SchedConfig cfg, FILE * out) {
+	fprintf(out, "levels = %d\n", cfg->levels);
+	fprintf(out, "quantum = ");
+	for (int i = 0; i < cfg->levels; i++) {
+		fprintf(out, i ? ",%u" : "%u", cfg->quantum[i]);
+	}
+	fprintf(out, "\n");
+	for (int i = 0; i < cfg->levels; i++) {
+		fprintf(out, "demote.%d = %d\npromote.%d = %d\n", i, cfg->demote[i], i, cfg->promote[i]);
+	}
+	fprintf(out, "reset_count = %d\n", cfg->reset_count);
+	fprintf(out, "aging = %d\n", cfg->aging);
+	fprintf(out, "age = ");
+	for (int i = 0; i < cfg->levels; i++) {
+		fprintf(out, i ? ",%u" : "%u", cfg->age[i]);
+	}
+	fprintf(out, "\n");
+	fprintf(out, "timer_range = %d\n", cfg->timer_range);
+	fprintf(out, "total_terminated = %d\n", cfg->total_terminated);
+	fprintf(out, "max_pcb_total = %d\n", cfg->max_pcb_total);
+	fprintf(out, "quantum_carry_over = %d\n", cfg->quantum_carry_over);
+	fprintf(out, "adaptive_quantum = %d\n", cfg->adaptive_quantum);
+	fprintf(out, "adapt_target = %d\n", cfg->adapt_target);
+	fprintf(out, "io_coalesce_count = %d\n", cfg->io_coalesce_count);
+	fprintf(out, "io_coalesce_ticks = %u\n", cfg->io_coalesce_ticks);
+	fprintf(out, "tickless_idle = %d\n", cfg->tickless_idle);
+	fprintf(out, "green_workers = %d\n", cfg->green_workers);
+	fprintf(out, "green_tick_us = %u\n", cfg->green_tick_us);
+	fprintf(out, "green_reset = %u\n", cfg->green_reset);
+	fprintf(out, "queue = %s\n", cfg->queue_kind == Q_RING ? "ring" : "list");
+	fprintf(out, "metrics_interval = %u\n", cfg->metrics_interval);
+	fprintf(out, "metrics_file = %s\n", cfg->metrics_file);
+	fprintf(out, "tick_limit = %u\n", cfg->tick_limit);
+	fprintf(out, "seed = %llu\n", cfg->seed);
+	if (cfg->replay_file[0]) {
+		fprintf(out, "workload = %s%s\n", CONFIG_REPLAY_PREFIX, cfg->replay_file);
+	} else if (cfg->use_generator) {
+		char settings[CONFIG_MAX_LINE];
+		generatorFormat(&cfg->generator, settings, sizeof(settings));
+		fprintf(out, "workload = %s\n", settings);
+	}
+}
@@ -0,0 +1,84 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the definitions of structs and declarations of functions for the
+	config.c file. Every tunable of the scheduler lives in one SchedConfig_s, which
+	starts out with the compile time defaults, can be loaded from a file of
+	"key = value" lines and overridden from the command line. Per-level settings
+	are kept as flat tables indexed by priority, so the scheduler reads them with
+	a single array lookup.
+*/
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+//includes
+#include "pcb.h"
+#include "fifo_queue.h"
+#include "workload_gen.h"
+#include <stdio.h>
+
+
+//defines
+#define CONFIG_MAX_LINE 512
+#define CONFIG_PATH_LENGTH 256
+#define CONFIG_LADDER_MULT 2.0
+#define CONFIG_REPLAY_PREFIX "replay:"
+
+
+//structs
+typedef struct sched_config {
+	int levels; // MLFQ levels in use, at most NUM_PRIORITIES
+	unsigned int quantum[NUM_PRIORITIES]; // quantum size of each level
+	unsigned char demote[NUM_PRIORITIES]; // level a PCB moves to when its quantum expires
+	unsigned char promote[NUM_PRIORITIES]; // level a PCB moves to when its I/O completes
+	unsigned int ladder_base; // when set, unset quanta are ladder_base * ladder_mult^level
+	double ladder_mult;
+	int reset_count;
+	int aging; // 1 to move long waiting PCBs up a level at a time instead of resetting the MLFQ
+	unsigned int age[NUM_PRIORITIES]; // ticks a PCB waits at a level before aging moves it up
+	int timer_range;
+	int total_terminated;
+	int max_pcb_total;
+	int quantum_carry_over;
+	int adaptive_quantum; // 1 to resize each level's quantum from the CPU bursts run at it
+	int adapt_target; // percent of a level's bursts its quantum should fit
+	int io_coalesce_count; // I/O completions woken by one interrupt, at most
+	unsigned int io_coalesce_ticks; // longest a completion waits for company, 0 for no limit
+	int tickless_idle; // 1 to jump over idle ticks in which nothing would happen
+	int green_workers; // pthreads the green thread runtime runs on
+	unsigned int green_tick_us; // microseconds in a tick of the green thread runtime
+	unsigned int green_reset; // its ticks between MLFQ resets, 0 for none
+	enum queue_kind queue_kind; // how every queue of the Scheduler keeps its PCBs
+	unsigned int metrics_interval;
+	char metrics_file[CONFIG_PATH_LENGTH]; // empty to not write a metrics file
+	unsigned int tick_limit; // 0 to run until the arrivals are done
+	unsigned long long seed; // 0 to seed from the clock
+	int use_generator;
+	Generator_s generator;
+	char replay_file[CONFIG_PATH_LENGTH]; // workload to replay, empty for none
+} SchedConfig_s;
+
+typedef SchedConfig_s * SchedConfig;
+
+
+//declarations
+extern SchedConfig_s config;
+extern SchedConfig_s baseConfig;
+
+void configDefaults (SchedConfig);
+
+int configSet (SchedConfig, const char *, const char *);
+
+int configSetPair (SchedConfig, const char *);
+
+int configLoad (SchedConfig, const char *);
+
+int configFinish (SchedConfig);
+
+void configPrint (SchedConfig, FILE *);
+
+char * trim (char *);
+
+#endif
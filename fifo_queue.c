@@ -3,36 +3,130 @@
 	Authors: Connor Lundberg, Jacob Ackerman
  */
 
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 /* primarily for sprintf */
 #include <stdio.h>
 
 #include "fifo_queue.h"
+#include "sim_log.h"
 
 #define PROCESS_QUEUE_DISPLAY_LENGTH 20
 #define POST_OUTPUT_BUFFER 5
 
 
+/* Nodes freed by dequeues, kept for the next enqueues so they need no malloc. */
+_Thread_local ReadyQueueNode freeNodes = NULL;
+_Thread_local unsigned int freeNodeCount = 0;
+
 
 /*
- * Create a new FIFO Queue.
+ * Takes a node off the free list, or mallocs one if the list is empty.
+ *
+ * Return: a node, NULL if none could be allocated.
+ */
+ReadyQueueNode q_alloc_node() {
+    ReadyQueueNode node = freeNodes;
+    if (node != NULL) {
+        freeNodes = node->next;
+        freeNodeCount--;
+    } else {
+        node = malloc(sizeof(Node_s));
+    }
+    return node;
+}
+
+/*
+ * Puts a chain of count nodes, first to last, back on the free list in one
+ * step. Once the list holds Q_FREE_NODES_MAX nodes the rest are freed.
+ */
+void q_release_nodes(ReadyQueueNode first, ReadyQueueNode last, unsigned int count) {
+    if (freeNodeCount + count <= Q_FREE_NODES_MAX) {
+        last->next = freeNodes;
+        freeNodes = first;
+        freeNodeCount += count;
+        return;
+    }
+    while (first != NULL && count-- > 0) {
+        ReadyQueueNode next = first->next;
+        if (freeNodeCount < Q_FREE_NODES_MAX) {
+            first->next = freeNodes;
+            freeNodes = first;
+            freeNodeCount++;
+        } else {
+            free(first);
+        }
+        first = next;
+    }
+}
+
+/*
+ * Makes sure the calling thread's free list holds at least count nodes, so
+ * that many can be taken from it without a malloc that could fail.
  *
+ * Return: 1 if it does, 0 if a node could not be allocated.
+ */
+int q_reserve_nodes(unsigned int count) {
+    while (freeNodeCount < count) {
+        ReadyQueueNode node = malloc(sizeof(Node_s));
+        if (node == NULL) {
+            return 0;
+        }
+        node->next = freeNodes;
+        freeNodes = node;
+        freeNodeCount++;
+    }
+    return 1;
+}
+
+/*
+ * Frees every node on the calling thread's free list. A thread that used
+ * queues calls this before it exits, or its nodes are lost with it.
+ */
+void q_free_nodes() {
+    while (freeNodes != NULL) {
+        ReadyQueueNode next = freeNodes->next;
+        free(freeNodes);
+        freeNodes = next;
+    }
+    freeNodeCount = 0;
+}
+
+
+
+/*
+ * Create a new FIFO Queue of the given kind.
+ *
+ * Arguments: kind: Q_LIST for a linked list of nodes, Q_RING for a ring buffer.
  * Return: a pointer to a new FIFO queue, NULL if unsuccessful.
  */
-ReadyQueue q_create() {
+ReadyQueue q_create_kind(enum queue_kind kind) {
     ReadyQueue new_queue = malloc(sizeof(FIFOq_s));
 
     if (new_queue != NULL) {
         new_queue->first_node = NULL;
         new_queue->last_node = NULL;
+        new_queue->ring = NULL;
+        new_queue->head = 0;
+        new_queue->capacity = 0;
 		new_queue->quantum_size = 0;
         new_queue->size = 0;
+        new_queue->kind = kind;
     }
 
     return new_queue;
 }
 
+/*
+ * Create a new FIFO Queue.
+ *
+ * Return: a pointer to a new FIFO queue, NULL if unsuccessful.
+ */
+ReadyQueue q_create() {
+    return q_create_kind(Q_LIST);
+}
+
 /*
  * Destroy a FIFO queue and all of its internal nodes.
  *
@@ -47,8 +141,12 @@ void q_destroy(/* in-out */ ReadyQueue FIFOq) {
         curr = iter;
         iter = iter->next;
         PCB_destroy(curr->pcb);
-        free(curr);
+        q_release_nodes(curr, curr, 1);
     }
+    for (unsigned int i = 0; FIFOq->kind == Q_RING && i < FIFOq->size; i++) {
+        PCB_destroy(FIFOq->ring[(FIFOq->head + i) & (FIFOq->capacity - 1)]);
+    }
+    free(FIFOq->ring);
     free(FIFOq);
 }
 
@@ -58,6 +156,48 @@ void setQuantumSize (ReadyQueue queue, int quantumSize) {
 }
 
 
+/*
+ * Makes room in a ring queue for at least needed PCBs, doubling its capacity
+ * until they fit. The PCBs are moved to the start of the new buffer, in order.
+ *
+ * Arguments: FIFOq: the ring queue to grow.
+ *            needed: how many PCBs it must hold.
+ * Return: 1 if they fit, 0 if the buffer could not be grown.
+ */
+int q_ring_reserve(/* in-out */ ReadyQueue FIFOq, unsigned int needed) {
+    unsigned int capacity = FIFOq->capacity ? FIFOq->capacity : Q_RING_START;
+    unsigned int first;
+    PCB * ring;
+
+    if (needed <= FIFOq->capacity) {
+        return 1;
+    }
+    while (capacity < needed) {
+        if (capacity > UINT_MAX / 2) {
+            return 0;
+        }
+        capacity *= 2;
+    }
+    ring = malloc(capacity * sizeof(PCB));
+    if (ring == NULL) {
+        return 0;
+    }
+    first = FIFOq->capacity - FIFOq->head;
+    if (first > FIFOq->size) {
+        first = FIFOq->size;
+    }
+    if (FIFOq->size > 0) {
+        memcpy(ring, FIFOq->ring + FIFOq->head, first * sizeof(PCB));
+        memcpy(ring + first, FIFOq->ring, (FIFOq->size - first) * sizeof(PCB));
+    }
+    free(FIFOq->ring);
+    FIFOq->ring = ring;
+    FIFOq->head = 0;
+    FIFOq->capacity = capacity;
+    return 1;
+}
+
+
 /*
  * Peeks and returns a PCB from the queue, unless the queue is empty in which case null is returned.
  *
@@ -66,12 +206,59 @@ void setQuantumSize (ReadyQueue queue, int quantumSize) {
  */
 PCB q_peek(ReadyQueue FIFOq) {
 	PCB headPCB = NULL;
-	if (FIFOq->first_node) {
+	if (FIFOq->size == 0) {
+		return NULL;
+	}
+	if (FIFOq->kind == Q_RING) {
+		headPCB = FIFOq->ring[FIFOq->head];
+	} else {
 		headPCB = FIFOq->first_node->pcb;
 	}
 	return headPCB;
 }
 
+
+/*
+ * Peeks and returns the PCB the given number of places behind the front of the queue.
+ *
+ * Arguments: FIFOq: the queue to peek into.
+ *            index: 0 for the front of the queue.
+ * Return: NULL if the queue is not that long, the PCB at that place otherwise.
+ */
+PCB q_peek_at(ReadyQueue FIFOq, unsigned int index) {
+	ReadyQueueNode node = FIFOq->first_node;
+	if (index >= FIFOq->size) {
+		return NULL;
+	}
+	if (FIFOq->kind == Q_RING) {
+		return FIFOq->ring[(FIFOq->head + index) & (FIFOq->capacity - 1)];
+	}
+	while (index-- > 0) {
+		node = node->next;
+	}
+	return node->pcb;
+}
+
+
+/*
+ * Calls visit on every PCB in the queue, front to back, with arg.
+ *
+ * Arguments: FIFOq: the queue to walk.
+ *            visit: called once for each PCB.
+ *            arg: handed to every call of visit.
+ */
+void q_visit(ReadyQueue FIFOq, void (* visit) (PCB, void *), void * arg) {
+	if (FIFOq->kind == Q_RING) {
+		for (unsigned int i = 0; i < FIFOq->size; i++) {
+			visit(FIFOq->ring[(FIFOq->head + i) & (FIFOq->capacity - 1)], arg);
+		}
+	} else {
+		for (ReadyQueueNode node = FIFOq->first_node; node != NULL; node = node->next) {
+			visit(node->pcb, arg);
+		}
+	}
+}
+
 /*
  * Checks if a queue is empty.
  *
@@ -79,7 +266,7 @@ PCB q_peek(ReadyQueue FIFOq) {
  * Return: 1 if empty, 0 otherwise.
  */
 char q_is_empty(/* in */ ReadyQueue FIFOq) {
-    return (FIFOq->first_node == NULL);
+    return (FIFOq->size == 0);
 }
 
 /*
@@ -90,9 +277,20 @@ char q_is_empty(/* in */ ReadyQueue FIFOq) {
  * Return: 1 if successful, 0 if unsuccessful.
  */
 int q_enqueue(/* in */ ReadyQueue FIFOq, /* in */ PCB pcb) {
-    ReadyQueueNode new_node = malloc(sizeof(Node_s));
+    ReadyQueueNode new_node;
+
+    if (FIFOq->kind == Q_RING) {
+        if (pcb == NULL || !q_ring_reserve(FIFOq, FIFOq->size + 1)) {
+            return 0;
+        }
+        FIFOq->ring[(FIFOq->head + FIFOq->size) & (FIFOq->capacity - 1)] = pcb;
+        FIFOq->size++;
+        return 1;
+    }
 
-    if (new_node != NULL && pcb != NULL) {
+    new_node = pcb != NULL ? q_alloc_node() : NULL;
+
+    if (new_node != NULL) {
         new_node->pcb = pcb;
         new_node->next = NULL;
 
@@ -121,6 +319,15 @@ PCB q_dequeue(/* in-out */ ReadyQueue FIFOq) {
     PCB ret_pcb = NULL;
     ReadyQueueNode ret_node = FIFOq->first_node;
 
+    if (FIFOq->kind == Q_RING) {
+        if (FIFOq->size > 0) {
+            ret_pcb = FIFOq->ring[FIFOq->head];
+            FIFOq->head = (FIFOq->head + 1) & (FIFOq->capacity - 1);
+            FIFOq->size--;
+        }
+        return ret_pcb;
+    }
+
     if (ret_node != NULL) {
         FIFOq->first_node = ret_node->next;
 
@@ -133,12 +340,153 @@ PCB q_dequeue(/* in-out */ ReadyQueue FIFOq) {
 
         ret_pcb = ret_node->pcb;
 
-        free(ret_node);
+        q_release_nodes(ret_node, ret_node, 1);
     }
 
     return ret_pcb;
 }
 
+/*
+ * Enqueues count PCBs in order. A list queue chains up the nodes first and
+ * links them on once; a ring queue copies them in with at most two memcpys.
+ *
+ * Arguments: FIFOq: the queue to enqueue to.
+ *            pcbs: the PCBs to enqueue, none of them NULL.
+ *            count: how many there are.
+ * Return: how many were enqueued, less than count only if there was no memory for them.
+ */
+unsigned int q_enqueue_batch(/* in-out */ ReadyQueue FIFOq, /* in */ PCB * pcbs, unsigned int count) {
+    ReadyQueueNode first = NULL, last = NULL;
+    unsigned int made;
+
+    if (FIFOq->kind == Q_RING) {
+        unsigned int tail, first_part;
+        if (count == 0 || !q_ring_reserve(FIFOq, FIFOq->size + count)) {
+            return 0;
+        }
+        tail = (FIFOq->head + FIFOq->size) & (FIFOq->capacity - 1);
+        first_part = FIFOq->capacity - tail < count ? FIFOq->capacity - tail : count;
+        memcpy(FIFOq->ring + tail, pcbs, first_part * sizeof(PCB));
+        memcpy(FIFOq->ring, pcbs + first_part, (count - first_part) * sizeof(PCB));
+        FIFOq->size += count;
+        return count;
+    }
+
+    for (made = 0; made < count; made++) {
+        ReadyQueueNode new_node = q_alloc_node();
+        if (new_node == NULL) {
+            break;
+        }
+        new_node->pcb = pcbs[made];
+        if (last != NULL) {
+            last->next = new_node;
+        } else {
+            first = new_node;
+        }
+        last = new_node;
+    }
+
+    if (made > 0) {
+        last->next = NULL;
+        if (FIFOq->last_node != NULL) {
+            FIFOq->last_node->next = first;
+        } else {
+            FIFOq->first_node = first;
+        }
+        FIFOq->last_node = last;
+        FIFOq->size += made;
+    }
+
+    return made;
+}
+
+/*
+ * Dequeues up to n PCBs from the front of the queue, in order. A list queue's
+ * nodes go back on the free list together.
+ *
+ * Arguments: FIFOq: the queue to dequeue from.
+ *            pcbs: filled with the dequeued PCBs, room for n.
+ *            n: the most to dequeue.
+ * Return: how many were dequeued, less than n only if the queue ran out.
+ */
+unsigned int q_dequeue_n(/* in-out */ ReadyQueue FIFOq, /* out */ PCB * pcbs, unsigned int n) {
+    ReadyQueueNode first = FIFOq->first_node, last = NULL, iter = first;
+    unsigned int taken = 0;
+
+    if (FIFOq->kind == Q_RING) {
+        unsigned int first_part;
+        taken = n < FIFOq->size ? n : FIFOq->size;
+        first_part = FIFOq->capacity - FIFOq->head < taken ? FIFOq->capacity - FIFOq->head : taken;
+        if (taken > 0) {
+            memcpy(pcbs, FIFOq->ring + FIFOq->head, first_part * sizeof(PCB));
+            memcpy(pcbs + first_part, FIFOq->ring, (taken - first_part) * sizeof(PCB));
+            FIFOq->head = (FIFOq->head + taken) & (FIFOq->capacity - 1);
+            FIFOq->size -= taken;
+        }
+        return taken;
+    }
+
+    while (iter != NULL && taken < n) {
+        pcbs[taken++] = iter->pcb;
+        last = iter;
+        iter = iter->next;
+    }
+
+    if (taken > 0) {
+        FIFOq->first_node = iter;
+        if (iter == NULL) {
+            FIFOq->last_node = NULL;
+        }
+        FIFOq->size -= taken;
+        q_release_nodes(first, last, taken);
+    }
+
+    return taken;
+}
+
+/*
+ * Moves every PCB of one queue onto the end of another, leaving the first
+ * empty. Between two list queues no node is copied, so it takes the same time
+ * for any length; otherwise the PCBs are copied across in batches. Room in
+ * dest is made before a batch is taken from src, so if memory runs out the
+ * PCBs not yet moved are left in src, in order.
+ *
+ * Arguments: dest: the queue to append to.
+ *            src: the queue to empty.
+ */
+void q_splice(/* in-out */ ReadyQueue dest, /* in-out */ ReadyQueue src) {
+    PCB batch[Q_SPLICE_BATCH];
+    unsigned int taken;
+
+    if (src->size == 0) {
+        return;
+    }
+    if (dest->kind == Q_LIST && src->kind == Q_LIST) {
+        if (dest->last_node != NULL) {
+            dest->last_node->next = src->first_node;
+        } else {
+            dest->first_node = src->first_node;
+        }
+        dest->last_node = src->last_node;
+        dest->size += src->size;
+        src->first_node = NULL;
+        src->last_node = NULL;
+        src->size = 0;
+        return;
+    }
+    if (dest->kind == Q_RING && !q_ring_reserve(dest, dest->size + src->size)) {
+        return;
+    }
+    while (src->size > 0) {
+        taken = src->size < Q_SPLICE_BATCH ? src->size : Q_SPLICE_BATCH;
+        if (dest->kind == Q_LIST && !q_reserve_nodes(taken)) {
+            return;
+        }
+        taken = q_dequeue_n(src, batch, taken);
+        q_enqueue_batch(dest, batch, taken);
+    }
+}
+
 /*
  * Creates and returns an output string representation of the FIFO queue.
  *
@@ -146,24 +494,27 @@ PCB q_dequeue(/* in-out */ ReadyQueue FIFOq) {
  *            display_back: 1 to display the final PCB, 0 otherwise.
  */
  void toStringReadyQueueNode(ReadyQueueNode theNode) {
-	printf("P%d",theNode->pcb->pid);
+	LOG("P%d",theNode->pcb->pid);
     if(theNode->next != 0) {
-        printf("->");
+        LOG("->");
     } else {
-        printf("->*");
+        LOG("->*");
     }
 }
 
+/*
+ * Logs one PCB of a queue being printed.
+ */
+void toStringQueuedPCB(PCB pcb, void * arg) {
+	LOG("P%d->", pcb->pid);
+}
+
 void toStringReadyQueue(ReadyQueue theQueue) {
-    if(theQueue->first_node == 0) {
-        printf("\r\n");
+    if(q_is_empty(theQueue)) {
+        LOG("\r\n");
     } else {
-        ReadyQueueNode temp = theQueue->first_node;
-        while(temp != 0) {
-            toStringReadyQueueNode(temp);
-            temp = temp->next;
-        }
-		printf("\r\n");
+        q_visit(theQueue, toStringQueuedPCB, NULL);
+		LOG("*\r\n");
     }
 }
 /*char * toStringReadyQueue(/* in  ReadyQueue FIFOq, /* in *char display_back) {
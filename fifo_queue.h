@@ -8,6 +8,16 @@
 
 #include "pcb.h"
 
+#define Q_FREE_NODES_MAX 65536 // nodes each thread keeps for reuse, the rest are freed
+#define Q_RING_START 16 // a ring queue's first buffer, doubled whenever it fills
+#define Q_SPLICE_BATCH 64 // PCBs copied at a time when splicing into or out of a ring queue
+
+/* How a queue keeps its PCBs. */
+enum queue_kind {
+    Q_LIST, // a linked list of nodes
+    Q_RING  // a ring buffer of PCB handles, a power of two long
+};
+
 /* A node used in a fifo queue to store data, and the next node. */
 typedef struct node {
     struct node * next;
@@ -16,12 +26,19 @@ typedef struct node {
 
 typedef Node_s * ReadyQueueNode;
 
-/* A fifo queue, which stores size and pointers to the first and last nodes. */
+/*
+ * A fifo queue, which stores size and either pointers to the first and last
+ * nodes or a ring buffer, by kind. Only fifo_queue.c looks inside.
+ */
 typedef struct fifo_queue {
-    ReadyQueueNode first_node;
+    ReadyQueueNode first_node; // Q_LIST
     ReadyQueueNode last_node;
+    PCB *          ring; // Q_RING, the front is at head
+    unsigned int   head;
+    unsigned int   capacity;
 	unsigned int quantum_size;
     unsigned int size;
+    enum queue_kind kind;
 } FIFOq_s;
 
 typedef FIFOq_s * ReadyQueue;
@@ -33,6 +50,14 @@ typedef FIFOq_s * ReadyQueue;
  */
 ReadyQueue q_create();
 
+/*
+ * Create a new FIFO Queue of the given kind.
+ *
+ * Arguments: kind: Q_LIST for a linked list of nodes, Q_RING for a ring buffer.
+ * Return: a pointer to a new FIFO queue, NULL if unsuccessful.
+ */
+ReadyQueue q_create_kind(enum queue_kind kind);
+
 /*
  * Destroy a FIFO queue and all of its internal nodes.
  *
@@ -68,6 +93,38 @@ int q_enqueue(/* in */ ReadyQueue FIFOq, /* in */ PCB pcb);
  */
 PCB q_dequeue(/* in-out */ ReadyQueue FIFOq);
 
+/*
+ * Enqueues count PCBs in order. A list queue chains up the nodes first and
+ * links them on once; a ring queue copies them in with at most two memcpys.
+ *
+ * Arguments: FIFOq: the queue to enqueue to.
+ *            pcbs: the PCBs to enqueue, none of them NULL.
+ *            count: how many there are.
+ * Return: how many were enqueued, less than count only if there was no memory for them.
+ */
+unsigned int q_enqueue_batch(/* in-out */ ReadyQueue FIFOq, /* in */ PCB * pcbs, unsigned int count);
+
+/*
+ * Dequeues up to n PCBs from the front of the queue, in order.
+ *
+ * Arguments: FIFOq: the queue to dequeue from.
+ *            pcbs: filled with the dequeued PCBs, room for n.
+ *            n: the most to dequeue.
+ * Return: how many were dequeued, less than n only if the queue ran out.
+ */
+unsigned int q_dequeue_n(/* in-out */ ReadyQueue FIFOq, /* out */ PCB * pcbs, unsigned int n);
+
+/*
+ * Moves every PCB of one queue onto the end of another, leaving the first
+ * empty. Between two list queues no node is copied, so it takes the same time
+ * for any length; otherwise the PCBs are copied across in batches. If memory
+ * runs out, the PCBs not yet moved are left in src, in order.
+ *
+ * Arguments: dest: the queue to append to.
+ *            src: the queue to empty.
+ */
+void q_splice(/* in-out */ ReadyQueue dest, /* in-out */ ReadyQueue src);
+
 /*
  * Peeks and returns a PCB from the queue, unless the queue is empty in which case null is returned.
  *
@@ -76,6 +133,30 @@ PCB q_dequeue(/* in-out */ ReadyQueue FIFOq);
  */
 PCB q_peek(ReadyQueue FIFOq);
 
+/*
+ * Peeks and returns the PCB the given number of places behind the front of the queue.
+ *
+ * Arguments: FIFOq: the queue to peek into.
+ *            index: 0 for the front of the queue.
+ * Return: NULL if the queue is not that long, the PCB at that place otherwise.
+ */
+PCB q_peek_at(ReadyQueue FIFOq, unsigned int index);
+
+/*
+ * Calls visit on every PCB in the queue, front to back, with arg.
+ *
+ * Arguments: FIFOq: the queue to walk.
+ *            visit: called once for each PCB.
+ *            arg: handed to every call of visit.
+ */
+void q_visit(ReadyQueue FIFOq, void (* visit) (PCB, void *), void * arg);
+
+/*
+ * Frees the nodes the calling thread keeps for reuse. Call it from a thread
+ * that used queues before the thread exits.
+ */
+void q_free_nodes();
+
 /*
  * Creates and returns an output string representation of the FIFO queue.
  *
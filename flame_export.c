@@ -0,0 +1,183 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the defined functions declared in the flame_export.h header file.
+	The totals are kept in an open addressing hash table. Runs of ticks with the
+	same key are added up before they reach the table, so a PCB running out its
+	quantum costs a compare per tick, and a lookup only when something changes.
+*/
+
+#include "flame_export.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+
+FILE * flameOut = NULL;
+FlameSlot_s * flameSlots = NULL;
+unsigned int flameCapacity = 0;
+unsigned int flameUsed = 0;
+unsigned long long pendingKey = 0; // the run of ticks not yet added to the table
+unsigned long long pendingTicks = 0;
+
+const char * flamePhaseNames[FLAME_PHASE_COUNT] = {
+	"user",
+	"switch",
+	"isr",
+	"idle"
+};
+
+
+/*
+	Packs the fields of a folded stack into one key. The level is stored one
+	higher so that idle's -1 fits, and the PID as unsigned for the same reason.
+*/
+unsigned long long flameKey (int cpu, int level, int pid, enum flame_phase phase) {
+	return ((unsigned long long) cpu << 56) | ((unsigned long long) phase << 48)
+		| ((unsigned long long) (level + 1) << 32) | (unsigned int) pid;
+}
+
+
+/*
+	Returns the slot holding key in a table of the given power of two capacity,
+	or the empty slot where it belongs.
+*/
+FlameSlot_s * flameFind (FlameSlot_s * slots, unsigned int capacity, unsigned long long key) {
+	unsigned int i = (unsigned int) ((key * 0x9E3779B97F4A7C15ULL) >> 32) & (capacity - 1);
+	while (slots[i].ticks != 0 && slots[i].key != key) {
+		i = (i + 1) & (capacity - 1);
+	}
+	return &slots[i];
+}
+
+
+/*
+	Adds ticks to key's total, doubling the table first if it is half full.
+	Ticks are dropped if the table can not grow.
+*/
+void flameAdd (unsigned long long key, unsigned long long ticks) {
+	FlameSlot_s * slot;
+	if (flameUsed * 2 >= flameCapacity) {
+		unsigned int capacity = flameCapacity * 2;
+		FlameSlot_s * slots = calloc(capacity, sizeof(FlameSlot_s));
+		if (slots == NULL) {
+			return;
+		}
+		for (unsigned int i = 0; i < flameCapacity; i++) {
+			if (flameSlots[i].ticks != 0) {
+				*flameFind(slots, capacity, flameSlots[i].key) = flameSlots[i];
+			}
+		}
+		free(flameSlots);
+		flameSlots = slots;
+		flameCapacity = capacity;
+	}
+	slot = flameFind(flameSlots, flameCapacity, key);
+	if (slot->ticks == 0) {
+		slot->key = key;
+		flameUsed++;
+	}
+	slot->ticks += ticks;
+}
+
+
+/*
+	Opens the given file for the folded stacks, which are written when it is
+	closed. Returns 1 on success, 0 if the file could not be opened.
+*/
+int flameOpen (const char * path) {
+	flameOut = fopen(path, "w");
+	if (flameOut == NULL) {
+		return 0;
+	}
+	flameCapacity = FLAME_START_SLOTS / 2; // flameAdd doubles it on first use
+	flameSlots = calloc(flameCapacity, sizeof(FlameSlot_s));
+	if (flameSlots == NULL) {
+		fclose(flameOut);
+		flameOut = NULL;
+		return 0;
+	}
+	flameUsed = 0;
+	pendingTicks = 0;
+	return 1;
+}
+
+
+/*
+	Orders slots by key, so the same run always writes the same file.
+*/
+int compareSlots (const void * a, const void * b) {
+	unsigned long long left = ((const FlameSlot_s *) a)->key, right = ((const FlameSlot_s *) b)->key;
+	return (left > right) - (left < right);
+}
+
+
+/*
+	Writes one line per key with the ticks it was given, and closes the file.
+*/
+void flameClose () {
+	unsigned int count = 0;
+	if (flameOut == NULL) {
+		return;
+	}
+	if (pendingTicks > 0) {
+		flameAdd(pendingKey, pendingTicks);
+		pendingTicks = 0;
+	}
+	for (unsigned int i = 0; i < flameCapacity; i++) {
+		if (flameSlots[i].ticks != 0) {
+			flameSlots[count++] = flameSlots[i];
+		}
+	}
+	qsort(flameSlots, count, sizeof(FlameSlot_s), compareSlots);
+	for (unsigned int i = 0; i < count; i++) {
+		unsigned long long key = flameSlots[i].key;
+		int cpu = key >> 56, phase = (key >> 48) & 0xFF, level = (int) ((key >> 32) & 0xFFFF) - 1;
+		int pid = (int) (unsigned int) key;
+		if (pid == FLAME_IDLE_PID) {
+			fprintf(flameOut, "cpu%d;-;idle;%s %llu\n", cpu, flamePhaseNames[phase], flameSlots[i].ticks);
+		} else {
+			fprintf(flameOut, "cpu%d;level%d;pid%d;%s %llu\n", cpu, level, pid, flamePhaseNames[phase],
+				flameSlots[i].ticks);
+		}
+	}
+	fclose(flameOut);
+	flameOut = NULL;
+	flameDetach();
+}
+
+
+/*
+	Lets go of the file and the totals without writing them, for a forked copy
+	of the simulation that must leave the file to its parent.
+*/
+void flameDetach () {
+	if (flameOut != NULL) {
+		fclose(flameOut);
+	}
+	free(flameSlots);
+	flameOut = NULL;
+	flameSlots = NULL;
+	flameCapacity = 0;
+	flameUsed = 0;
+	pendingTicks = 0;
+}
+
+
+/*
+	Counts ticks of the given phase for the PID (FLAME_IDLE_PID for none) at the
+	given level on the given CPU.
+*/
+void flameCount (int cpu, int level, int pid, enum flame_phase phase, unsigned int ticks) {
+	unsigned long long key;
+	if (flameSlots == NULL) {
+		return;
+	}
+	key = flameKey(cpu, level, pid, phase);
+	if (key != pendingKey && pendingTicks > 0) {
+		flameAdd(pendingKey, pendingTicks);
+		pendingTicks = 0;
+	}
+	pendingKey = key;
+	pendingTicks += ticks;
+}
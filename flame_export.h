@@ -0,0 +1,53 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the definitions of structs and declarations of functions for the
+	flame_export.c file. It adds up where every simulated tick went, by CPU, MLFQ
+	level, PID and phase, and writes the totals as folded stacks:
+
+		cpu0;level3;pid12;user 48211
+
+	which flamegraph.pl, speedscope and most other flame graph tools read as
+	they are. Idle ticks are written as cpu0;-;idle;idle.
+*/
+
+#ifndef FLAME_EXPORT_H
+#define FLAME_EXPORT_H
+
+//includes
+#include "pcb.h"
+
+
+//defines
+#define FLAME_START_SLOTS 1024 // a power of two, doubled whenever the table is half full
+#define FLAME_IDLE_PID -1
+
+
+//enums
+enum flame_phase {
+	FLAME_USER, // the running PCB advanced a tick
+	FLAME_SWITCH, // an ISR tick that ended with another PCB running
+	FLAME_ISR, // an ISR tick that went back to the PCB it interrupted
+	FLAME_IDLE,
+	FLAME_PHASE_COUNT
+};
+
+
+//structs
+typedef struct flame_slot {
+	unsigned long long key; // cpu, phase, level and PID packed by flameKey
+	unsigned long long ticks; // 0 for an empty slot
+} FlameSlot_s;
+
+
+//declarations
+int flameOpen (const char *);
+
+void flameClose ();
+
+void flameDetach ();
+
+void flameCount (int, int, int, enum flame_phase, unsigned int);
+
+#endif
@@ -0,0 +1,663 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the defined functions declared in the green.h header file.
+	A thread is never put on a queue by itself: it records why it stopped and
+	switches back to its worker, and the worker queues it once it is off the
+	thread's stack, so no other worker can resume a thread that is still
+	running. A thread can be resumed by any worker, so which worker it is on is
+	looked up again after every switch.
+
+	The benchmark runs three cases on the runtime, and the same work on plain
+	pthreads, one OS thread per green thread:
+
+		scheduler -G green.csv -o green_workers=4
+
+	switch times two threads handing one worker back and forth, against two
+	pthreads taking turns on a condition variable. fairness runs
+	GREEN_BENCH_HOGS CPU bound threads per worker for GREEN_BENCH_WINDOW_MS and
+	gives Jain's index of the work each got done, 1 when all got the same.
+	wakeup runs the same hogs beside a thread that sleeps GREEN_BENCH_NAP_US at
+	a time, and gives how late it woke.
+*/
+
+#define _GNU_SOURCE // for SIGEV_THREAD_ID
+
+#include "green.h"
+#include "scheduler.h"
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+
+GreenRuntime_s greenRuntime;
+_Thread_local GreenWorker greenSelf = NULL;
+
+unsigned long long benchDeadline; // microseconds the fairness and wakeup cases stop at
+LatencyHist_s benchLate; // how late the wakeup case's sleeper woke, in microseconds
+pthread_mutex_t pingLock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t pingTurned = PTHREAD_COND_INITIALIZER;
+int pingTurn;
+
+
+/*
+	Returns the worker the calling OS thread is. It is never inlined or looked
+	into, so a green thread that moved to another worker does not reuse the
+	address of the one it left.
+*/
+__attribute__((noipa)) GreenWorker currentWorker () {
+	return greenSelf;
+}
+
+
+/*
+	Returns the ticks of green_tick_us since the runtime was started.
+*/
+unsigned int greenNow () {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((now.tv_sec - greenRuntime.start.tv_sec) * 1000000LL
+		+ (now.tv_nsec - greenRuntime.start.tv_nsec) / 1000) / config.green_tick_us;
+}
+
+
+/*
+	Sets when to the wall time of the given tick.
+*/
+void greenTickTime (unsigned int tick, struct timespec * when) {
+	unsigned long long ns = (unsigned long long) tick * config.green_tick_us * 1000 + greenRuntime.start.tv_nsec;
+	when->tv_sec = greenRuntime.start.tv_sec + ns / 1000000000;
+	when->tv_nsec = ns % 1000000000;
+}
+
+
+/*
+	The timer signal. Raises the worker's preempt flag if its thread's quantum
+	has run out, or a sleeping thread is due back and should get a worker.
+*/
+void greenTick (int number) {
+	GreenWorker worker = greenSelf;
+	unsigned int now;
+	if (worker == NULL || worker->current == NULL) {
+		return;
+	}
+	now = greenNow();
+	if (now >= worker->quantum_end) {
+		worker->preempt = GREEN_PREEMPTED;
+	} else if (now >= __atomic_load_n(&greenRuntime.next_wake, __ATOMIC_RELAXED)) {
+		worker->preempt = GREEN_YIELDED;
+	}
+}
+
+
+/*
+	Sets up an empty runtime with the given number of workers, and the MLFQ
+	levels and quanta of the config. Returns 0 if the queues could not be made.
+*/
+int greenInit (int workers) {
+	pthread_condattr_t monotonic;
+	memset(&greenRuntime, 0, sizeof(greenRuntime));
+	pthread_mutex_init(&greenRuntime.lock, NULL);
+	pthread_condattr_init(&monotonic);
+	pthread_condattr_setclock(&monotonic, CLOCK_MONOTONIC);
+	pthread_cond_init(&greenRuntime.work, &monotonic);
+	pthread_condattr_destroy(&monotonic);
+	greenRuntime.ready = pq_create_kind(config.queue_kind);
+	greenRuntime.blocked = q_create_kind(config.queue_kind);
+	if (greenRuntime.ready == NULL || greenRuntime.blocked == NULL) {
+		return 0;
+	}
+	pq_set_levels(greenRuntime.ready, config.levels);
+	for (int i = 0; i < config.levels; i++) {
+		setQuantumSize(greenRuntime.ready->queues[i], config.quantum[i]);
+	}
+	greenRuntime.workers = workers;
+	greenRuntime.next_wake = GREEN_NEVER;
+	greenRuntime.next_reset = config.green_reset ? config.green_reset : GREEN_NEVER;
+	clock_gettime(CLOCK_MONOTONIC, &greenRuntime.start);
+	return 1;
+}
+
+
+/*
+	Gives the calling thread's worker back, for the given reason. Returns once
+	a worker, maybe another one, resumes the thread.
+*/
+void greenSwitch (enum green_reason reason) {
+	GreenWorker worker = currentWorker();
+	GreenThread thread = worker->current;
+	thread->reason = reason;
+	swapcontext(&thread->context, &worker->context);
+}
+
+
+/*
+	Where every green thread starts: runs its function, then gives its worker
+	back for good.
+*/
+void greenStart () {
+	GreenThread thread = currentWorker()->current;
+	thread->func(thread->arg);
+	greenSwitch(GREEN_FINISHED);
+}
+
+
+/*
+	Makes a green thread that will run func with arg, at priority 0, and makes
+	it ready. May be called before greenRun or from a green thread. Returns
+	NULL if its stack could not be made.
+*/
+GreenThread greenSpawn (GreenFunc func, void * arg) {
+	long page = sysconf(_SC_PAGESIZE);
+	GreenThread thread = calloc(1, sizeof(GreenThread_s));
+	unsigned int now;
+	if (thread == NULL) {
+		return NULL;
+	}
+	thread->stack = mmap(NULL, page + GREEN_STACK_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (thread->stack == MAP_FAILED) {
+		free(thread);
+		return NULL;
+	}
+	mprotect(thread->stack, page, PROT_NONE); // an overflow faults instead of writing over something
+	getcontext(&thread->context);
+	thread->context.uc_stack.ss_sp = thread->stack + page;
+	thread->context.uc_stack.ss_size = GREEN_STACK_SIZE;
+	thread->context.uc_link = NULL;
+	sigdelset(&thread->context.uc_sigmask, SIGRTMIN);
+	makecontext(&thread->context, greenStart, 0);
+	thread->func = func;
+	thread->arg = arg;
+	thread->pcb.context = &thread->cpu;
+	thread->pcb.first_run = -1;
+
+	pthread_mutex_lock(&greenRuntime.lock);
+	now = greenNow();
+	PCB_assign_PID(&thread->pcb);
+	thread->pcb.creation = now;
+	thread->pcb.state_since = now;
+	PCB_transition(&thread->pcb, STATE_READY, now);
+	pq_enqueue(greenRuntime.ready, &thread->pcb);
+	greenRuntime.live++;
+	pthread_cond_signal(&greenRuntime.work);
+	pthread_mutex_unlock(&greenRuntime.lock);
+	return thread;
+}
+
+
+/*
+	Frees a finished thread. Its worker must be off its stack.
+*/
+void greenFree (GreenThread thread) {
+	munmap(thread->stack, sysconf(_SC_PAGESIZE) + GREEN_STACK_SIZE);
+	free(thread);
+}
+
+
+/*
+	Moves every sleeping thread due back by now from the Blocked queue to the
+	level its wake promotes it to, if any is. Called with the lock held.
+*/
+void greenWake (unsigned int now) {
+	unsigned int count = greenRuntime.blocked->size, next = GREEN_NEVER;
+	if (now < greenRuntime.next_wake) {
+		return;
+	}
+	for (unsigned int i = 0; i < count; i++) {
+		GreenThread thread = (GreenThread) q_dequeue(greenRuntime.blocked);
+		if (thread->wake <= now) {
+			thread->pcb.priority = config.promote[thread->pcb.priority];
+			PCB_transition(&thread->pcb, STATE_READY, now);
+			pq_enqueue(greenRuntime.ready, &thread->pcb);
+			metricsInc(MET_IO_COMPLETIONS);
+			pthread_cond_signal(&greenRuntime.work);
+		} else {
+			q_enqueue(greenRuntime.blocked, &thread->pcb);
+			if (thread->wake < next) {
+				next = thread->wake;
+			}
+		}
+	}
+	__atomic_store_n(&greenRuntime.next_wake, next, __ATOMIC_RELAXED);
+}
+
+
+/*
+	Moves every ready thread back to priority 0, as resetMLFQ does. Called with
+	the lock held.
+*/
+void greenReset (unsigned int now) {
+	PriorityQueue ready = greenRuntime.ready;
+	for (int i = 1; i < ready->levels; i++) {
+		resetReadyQueue(ready->queues[i]);
+		q_splice(ready->queues[0], ready->queues[i]);
+	}
+	greenRuntime.resets++;
+	greenRuntime.next_reset = now + config.green_reset;
+	metricsInc(MET_MLFQ_BOOSTS);
+}
+
+
+/*
+	Runs the thread on the worker until it gives the worker back, then puts it
+	where its reason says. Called with the lock held, and returns with it held.
+*/
+void greenDispatch (GreenWorker worker, GreenThread thread) {
+	unsigned int now = greenNow();
+	unsigned int quantum = thread->pcb.quantum_remaining ? thread->pcb.quantum_remaining
+		: greenRuntime.ready->queues[thread->pcb.priority]->quantum_size;
+	PCB_transition(&thread->pcb, STATE_RUNNING, now);
+	thread->pcb.quantum_remaining = 0;
+	thread->reason = GREEN_RUNNING;
+	metricsInc(MET_CONTEXT_SWITCHES);
+	pthread_mutex_unlock(&greenRuntime.lock);
+
+	worker->current = thread;
+	worker->quantum_end = now + quantum;
+	worker->preempt = GREEN_RUNNING;
+	worker->dispatches++;
+	swapcontext(&worker->context, &thread->context);
+	worker->current = NULL;
+
+	pthread_mutex_lock(&greenRuntime.lock);
+	now = greenNow();
+	thread->pcb.user_ticks += now - thread->pcb.state_since;
+	if (config.quantum_carry_over && worker->quantum_end > now
+			&& (thread->reason == GREEN_YIELDED || thread->reason == GREEN_SLEEPING)) {
+		thread->pcb.quantum_remaining = worker->quantum_end - now;
+	}
+	if (thread->reason == GREEN_FINISHED) {
+		thread->pcb.termination = now;
+		PCB_transition(&thread->pcb, STATE_HALT, now);
+		metricsInc(MET_TERMINATIONS);
+		greenFree(thread);
+		if (--greenRuntime.live == 0) {
+			pthread_cond_broadcast(&greenRuntime.work);
+		}
+	} else if (thread->reason == GREEN_SLEEPING) {
+		PCB_transition(&thread->pcb, STATE_WAIT, now);
+		thread->pcb.io_count++;
+		q_enqueue(greenRuntime.blocked, &thread->pcb);
+		if (thread->wake < greenRuntime.next_wake) {
+			__atomic_store_n(&greenRuntime.next_wake, thread->wake, __ATOMIC_RELAXED);
+		}
+		greenRuntime.sleeps++;
+		metricsInc(MET_IO_TRAPS);
+	} else {
+		if (thread->reason == GREEN_PREEMPTED) {
+			thread->pcb.priority = config.demote[thread->pcb.priority];
+			greenRuntime.preemptions++;
+			metricsInc(MET_TIMER_INTERRUPTS);
+		}
+		PCB_transition(&thread->pcb, STATE_READY, now);
+		pq_enqueue(greenRuntime.ready, &thread->pcb);
+	}
+}
+
+
+/*
+	A worker's loop: wakes the sleepers due back, resets the MLFQ when it is
+	time, and runs the thread the MLFQ gives it, until every thread has finished.
+	With nothing ready it waits for a thread to be made ready or the first
+	sleeper to be due back.
+*/
+void * greenWorkerMain (void * arg) {
+	GreenWorker worker = arg;
+	struct sigevent event;
+	struct itimerspec every;
+	greenSelf = worker;
+
+	memset(&event, 0, sizeof(event));
+	event.sigev_notify = SIGEV_THREAD_ID;
+	event.sigev_signo = SIGRTMIN;
+	event._sigev_un._tid = syscall(SYS_gettid); // sigev_notify_thread_id, which older glibc does not name
+	every.it_interval.tv_sec = GREEN_SIGNAL_US / 1000000;
+	every.it_interval.tv_nsec = GREEN_SIGNAL_US % 1000000 * 1000;
+	every.it_value = every.it_interval;
+	if (timer_create(CLOCK_MONOTONIC, &event, &worker->timer) == 0) {
+		worker->timed = 1;
+		timer_settime(worker->timer, 0, &every, NULL);
+	}
+
+	pthread_mutex_lock(&greenRuntime.lock);
+	while (greenRuntime.live > 0) {
+		unsigned int now = greenNow();
+		PCB next;
+		greenWake(now);
+		if (now >= greenRuntime.next_reset) {
+			greenReset(now);
+		}
+		next = pq_dequeue(greenRuntime.ready);
+		if (next != NULL) {
+			greenDispatch(worker, (GreenThread) next);
+		} else if (greenRuntime.next_wake != GREEN_NEVER) {
+			struct timespec until;
+			greenTickTime(greenRuntime.next_wake, &until);
+			pthread_cond_timedwait(&greenRuntime.work, &greenRuntime.lock, &until);
+		} else {
+			pthread_cond_wait(&greenRuntime.work, &greenRuntime.lock);
+		}
+	}
+	pthread_mutex_unlock(&greenRuntime.lock);
+
+	if (worker->timed) {
+		timer_delete(worker->timer);
+	}
+	q_free_nodes();
+	greenSelf = NULL;
+	return NULL;
+}
+
+
+/*
+	Runs the threads made so far, and any they make, on the workers until every
+	one has finished, then frees the queues. Returns 0 if no worker could be
+	started.
+*/
+int greenRun () {
+	struct sigaction tick, previous;
+	int started = 0;
+	memset(&tick, 0, sizeof(tick));
+	tick.sa_handler = greenTick;
+	tick.sa_flags = SA_RESTART;
+	sigemptyset(&tick.sa_mask);
+	sigaction(SIGRTMIN, &tick, &previous);
+
+	for (int i = 0; i < greenRuntime.workers; i++) {
+		if (pthread_create(&greenRuntime.worker[i].thread, NULL, greenWorkerMain, &greenRuntime.worker[i]) != 0) {
+			break;
+		}
+		started++;
+	}
+	for (int i = 0; i < started; i++) {
+		pthread_join(greenRuntime.worker[i].thread, NULL);
+	}
+
+	sigaction(SIGRTMIN, &previous, NULL);
+	pq_destroy(greenRuntime.ready);
+	q_destroy(greenRuntime.blocked);
+	pthread_cond_destroy(&greenRuntime.work);
+	pthread_mutex_destroy(&greenRuntime.lock);
+	return started > 0;
+}
+
+
+/*
+	Gives the worker to the next ready thread, keeping this one's level. Does
+	nothing outside a green thread.
+*/
+void greenYield () {
+	GreenWorker worker = currentWorker();
+	if (worker != NULL && worker->current != NULL) {
+		worker->current->cpu.pc++;
+		greenSwitch(GREEN_YIELDED);
+	}
+}
+
+
+/*
+	A safe point: gives the worker back if the timer signal asked for it, moving
+	down a level if the quantum ran out. Cheap enough for the inside of a loop.
+*/
+void greenCheck () {
+	GreenWorker worker = currentWorker();
+	if (worker != NULL && worker->current != NULL) {
+		worker->current->cpu.pc++;
+		if (worker->preempt != GREEN_RUNNING) {
+			greenSwitch(worker->preempt);
+		}
+	}
+}
+
+
+/*
+	Blocks the thread for the given ticks. It waits in the Blocked queue and is
+	promoted on waking, as after an I/O trap.
+*/
+void greenSleep (unsigned int ticks) {
+	GreenWorker worker = currentWorker();
+	if (worker != NULL && worker->current != NULL) {
+		worker->current->cpu.pc++;
+		worker->current->wake = greenNow() + ticks;
+		greenSwitch(GREEN_SLEEPING);
+	}
+}
+
+
+/*
+	Returns microseconds on the monotonic clock.
+*/
+unsigned long long benchMicros () {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000ULL + now.tv_nsec / 1000;
+}
+
+
+/*
+	Does one unit of a hog's work.
+*/
+void benchSpin () {
+	volatile unsigned int sink = 0;
+	for (unsigned int i = 0; i < GREEN_BENCH_SPIN; i++) {
+		sink += i;
+	}
+}
+
+
+/*
+	The green thread of the switch case: yields GREEN_BENCH_SWITCHES times.
+*/
+void greenPing (void * arg) {
+	for (int i = 0; i < GREEN_BENCH_SWITCHES; i++) {
+		greenYield();
+	}
+}
+
+
+/*
+	The pthread of the switch case: takes its turn GREEN_BENCH_SWITCHES times,
+	handing it to the other each time.
+*/
+void * pthreadPing (void * arg) {
+	int side = (int) (intptr_t) arg;
+	for (int i = 0; i < GREEN_BENCH_SWITCHES; i++) {
+		pthread_mutex_lock(&pingLock);
+		while (pingTurn != side) {
+			pthread_cond_wait(&pingTurned, &pingLock);
+		}
+		pingTurn = !side;
+		pthread_cond_signal(&pingTurned);
+		pthread_mutex_unlock(&pingLock);
+	}
+	return NULL;
+}
+
+
+/*
+	A green hog: counts units of work into arg until the deadline.
+*/
+void greenHog (void * arg) {
+	unsigned long long * done = arg;
+	while (benchMicros() < benchDeadline) {
+		benchSpin();
+		(*done)++;
+		greenCheck();
+	}
+}
+
+
+/*
+	The pthread hog, the same without the safe point.
+*/
+void * pthreadHog (void * arg) {
+	unsigned long long * done = arg;
+	while (benchMicros() < benchDeadline) {
+		benchSpin();
+		(*done)++;
+	}
+	return NULL;
+}
+
+
+/*
+	The green sleeper: sleeps GREEN_BENCH_NAP_US at a time until the deadline,
+	recording how late it woke each time.
+*/
+void greenSleeper (void * arg) {
+	unsigned int ticks = GREEN_BENCH_NAP_US / config.green_tick_us;
+	unsigned long long nap;
+	ticks = ticks ? ticks : 1;
+	nap = (unsigned long long) ticks * config.green_tick_us;
+	while (benchMicros() < benchDeadline) {
+		unsigned long long asleep = benchMicros(), late;
+		greenSleep(ticks);
+		late = benchMicros() - asleep;
+		histRecord(&benchLate, late > nap ? late - nap : 0);
+	}
+}
+
+
+/*
+	The pthread sleeper, the same on nanosleep.
+*/
+void * pthreadSleeper (void * arg) {
+	struct timespec nap = {0, GREEN_BENCH_NAP_US * 1000};
+	while (benchMicros() < benchDeadline) {
+		unsigned long long asleep = benchMicros(), late;
+		nanosleep(&nap, NULL);
+		late = benchMicros() - asleep;
+		histRecord(&benchLate, late > GREEN_BENCH_NAP_US ? late - GREEN_BENCH_NAP_US : 0);
+	}
+	return NULL;
+}
+
+
+/*
+	Runs hogs, and a sleeper if asked for, on the green runtime or on pthreads
+	until benchDeadline, filling done with each hog's units of work. Returns 0
+	if they could not all be started.
+*/
+int runHogs (int green, int hogs, int sleeper, unsigned long long * done) {
+	pthread_t * threads = malloc((hogs + 1) * sizeof(pthread_t));
+	int started = 0, ok = 1;
+	histReset(&benchLate);
+	if (green && !greenInit(config.green_workers)) {
+		free(threads);
+		return 0;
+	}
+	benchDeadline = benchMicros() + GREEN_BENCH_WINDOW_MS * 1000ULL;
+	for (int i = 0; i < hogs + sleeper && ok; i++) {
+		if (green) {
+			ok = greenSpawn(i < hogs ? greenHog : greenSleeper, &done[i]) != NULL;
+		} else {
+			ok = pthread_create(&threads[i], NULL, i < hogs ? pthreadHog : pthreadSleeper, &done[i]) == 0;
+			started += ok;
+		}
+	}
+	if (green) {
+		ok = greenRun() && ok;
+	}
+	for (int i = 0; i < started; i++) {
+		pthread_join(threads[i], NULL);
+	}
+	free(threads);
+	return ok;
+}
+
+
+/*
+	Returns Jain's fairness index of the given amounts: 1 when they are all the
+	same, down to 1/count when one got everything.
+*/
+double jainIndex (unsigned long long * amounts, int count) {
+	double sum = 0, squares = 0;
+	for (int i = 0; i < count; i++) {
+		sum += amounts[i];
+		squares += (double) amounts[i] * amounts[i];
+	}
+	return squares > 0 ? sum * sum / (count * squares) : 1.0;
+}
+
+
+/*
+	Prints one result and writes it to the CSV file.
+*/
+void benchRow (FILE * out, const char * benchCase, const char * runtime, const char * measure, double value) {
+	fprintf(out, "%s,%s,%s,%.4f\n", benchCase, runtime, measure, value);
+	printf("%-9s %-8s %-16s %12.3f\r\n", benchCase, runtime, measure, value);
+}
+
+
+/*
+	Runs the switch, fairness and wakeup cases on the green runtime and on
+	pthreads, and writes the results to the file at path.
+*/
+int runGreenBench (const char * path) {
+	int hogs = config.green_workers * GREEN_BENCH_HOGS, savedLog = logEnabled;
+	unsigned long long * done = calloc(hogs + 1, sizeof(unsigned long long));
+	const char * runtimes[] = {"pthread", "green"};
+	pthread_t sides[2];
+	unsigned long long start;
+	FILE * out = fopen(path, "w");
+	if (out == NULL || done == NULL) {
+		fprintf(stderr, "Could not open %s\r\n", path);
+		free(done);
+		return 0;
+	}
+	fprintf(out, "case,runtime,measure,value\n");
+	printf("%-9s %-8s %-16s %12s\r\n", "case", "runtime", "measure", "value");
+	logEnabled = 0;
+
+	pingTurn = 0;
+	start = benchMicros();
+	pthread_create(&sides[0], NULL, pthreadPing, (void *) 0);
+	pthread_create(&sides[1], NULL, pthreadPing, (void *) 1);
+	pthread_join(sides[0], NULL);
+	pthread_join(sides[1], NULL);
+	benchRow(out, "switch", "pthread", "ns_per_switch", (benchMicros() - start) * 1000.0 / (2.0 * GREEN_BENCH_SWITCHES));
+
+	if (!greenInit(1)) {
+		fprintf(stderr, "Could not start the green runtime\r\n");
+		logEnabled = savedLog;
+		fclose(out);
+		free(done);
+		return 0;
+	}
+	greenSpawn(greenPing, NULL);
+	greenSpawn(greenPing, NULL);
+	start = benchMicros();
+	greenRun();
+	benchRow(out, "switch", "green", "ns_per_switch", (benchMicros() - start) * 1000.0 / (2.0 * GREEN_BENCH_SWITCHES));
+
+	for (int green = 0; green <= 1; green++) {
+		unsigned long long total = 0;
+		memset(done, 0, (hogs + 1) * sizeof(unsigned long long));
+		if (!runHogs(green, hogs, 0, done)) {
+			fprintf(stderr, "Could not start %d %s threads\r\n", hogs, runtimes[green]);
+			break;
+		}
+		for (int i = 0; i < hogs; i++) {
+			total += done[i];
+		}
+		benchRow(out, "fairness", runtimes[green], "jain_index", jainIndex(done, hogs));
+		benchRow(out, "fairness", runtimes[green], "units_per_sec", total * 1000.0 / GREEN_BENCH_WINDOW_MS);
+		if (green) {
+			benchRow(out, "fairness", "green", "preemptions", greenRuntime.preemptions);
+		}
+	}
+
+	for (int green = 0; green <= 1; green++) {
+		if (!runHogs(green, hogs, 1, done)) {
+			fprintf(stderr, "Could not start %d %s threads\r\n", hogs + 1, runtimes[green]);
+			break;
+		}
+		benchRow(out, "wakeup", runtimes[green], "p50_late_us", histValueAtPercentile(&benchLate, 50.0));
+		benchRow(out, "wakeup", runtimes[green], "p99_late_us", histValueAtPercentile(&benchLate, 99.0));
+	}
+	logEnabled = savedLog;
+	fclose(out);
+	free(done);
+	return 1;
+}
@@ -0,0 +1,130 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the definitions of structs and declarations of functions for the
+	green.c file. The green thread runtime runs real C functions the way the
+	simulator runs PCBs: each green thread is a PCB with its own stack and
+	ucontext, the MLFQ picks which one runs next, and a pool of worker pthreads
+	runs them, M green threads on N workers. A thread that sleeps goes to the
+	Blocked queue until it is due back, and one that uses up its quantum is
+	moved down a level, so the levels, quanta, demotions, promotions and resets
+	are the ones the config gives the simulator, with a quantum counted in ticks
+	of green_tick_us. The MLFQ is reset every green_reset ticks, since the
+	simulator's reset_count counts loop iterations, which the runtime has none of.
+
+	Each worker has a timer that signals it every GREEN_SIGNAL_US. Like the
+	simulator's, a quantum runs out at a deadline tick, and the signal only
+	checks it: once it has passed, or a sleeping thread is due back, the signal
+	raises the worker's preempt flag. The thread gives up the worker at its
+	next greenCheck, since switching stacks inside the handler could leave a
+	lock the thread held, in malloc or stdio, held by nobody who can run. A
+	thread that never calls greenCheck, greenYield or greenSleep keeps its
+	worker until it returns.
+*/
+
+#ifndef GREEN_H
+#define GREEN_H
+
+//includes
+#include "priority_queue.h"
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <time.h>
+#include <ucontext.h>
+
+
+//defines
+#define GREEN_MAX_WORKERS 64
+#define GREEN_SIGNAL_US 1000 // microseconds between a worker's timer signals
+#define GREEN_NEVER 0xFFFFFFFF // the next wake when nothing sleeps
+#define GREEN_STACK_SIZE (64 * 1024) // each thread's stack, past a guard page
+#define GREEN_BENCH_SWITCHES 200000 // yields each side of the switch case makes
+#define GREEN_BENCH_WINDOW_MS 500 // how long the fairness and wakeup cases run for
+#define GREEN_BENCH_HOGS 4 // CPU bound threads per worker in the fairness and wakeup cases
+#define GREEN_BENCH_NAP_US 1000 // how long the wakeup case's sleeper sleeps each time
+#define GREEN_BENCH_SPIN 1000 // loop iterations in one unit of a hog's work
+
+
+//enums
+/* Why a thread gave its worker back. */
+enum green_reason {
+	GREEN_RUNNING, // has not given it back
+	GREEN_YIELDED, // goes to the back of its level
+	GREEN_PREEMPTED, // its quantum ran out, it moves down a level
+	GREEN_SLEEPING, // goes to the Blocked queue until it is due back
+	GREEN_FINISHED // its function returned
+};
+
+
+//structs
+typedef void (* GreenFunc) (void *);
+
+/*
+	A green thread. The PCB comes first, so the PCB the MLFQ hands back is the
+	thread itself.
+*/
+typedef struct green_thread {
+	PCB_s pcb;
+	CPU_context_s cpu; // the PCB's context, its pc counts the safe points passed
+	ucontext_t context;
+	unsigned char * stack; // the mapping, guard page first
+	GreenFunc func;
+	void * arg;
+	enum green_reason reason; // set by the thread just before it switches back
+	unsigned int wake; // tick a sleeping thread is due back
+} GreenThread_s;
+
+typedef GreenThread_s * GreenThread;
+
+typedef struct green_worker {
+	pthread_t thread;
+	timer_t timer;
+	int timed; // 1 once the timer was made
+	ucontext_t context; // the worker's own loop, switched back to between threads
+	GreenThread current;
+	volatile unsigned int quantum_end; // tick the running thread's quantum runs out at
+	volatile sig_atomic_t preempt; // the reason the signal wants the thread off, GREEN_RUNNING for none
+	unsigned long long dispatches;
+} GreenWorker_s;
+
+typedef GreenWorker_s * GreenWorker;
+
+typedef struct green_runtime {
+	pthread_mutex_t lock; // guards the queues and the counts below
+	pthread_cond_t work; // signalled when a thread becomes ready or the last one finishes
+	PriorityQueue ready;
+	ReadyQueue blocked; // sleeping threads, in no order
+	unsigned int live; // threads made and not yet finished
+	unsigned int next_wake; // tick the first sleeping thread is due back, or GREEN_NEVER
+	unsigned int next_reset; // tick the MLFQ is next reset at
+	struct timespec start; // tick 0
+	int workers;
+	GreenWorker_s worker[GREEN_MAX_WORKERS];
+	unsigned long long preemptions;
+	unsigned long long sleeps;
+	unsigned long long resets;
+} GreenRuntime_s;
+
+
+//declarations
+extern GreenRuntime_s greenRuntime;
+
+unsigned int greenNow ();
+
+int greenInit (int);
+
+GreenThread greenSpawn (GreenFunc, void *);
+
+int greenRun ();
+
+void greenYield ();
+
+void greenCheck ();
+
+void greenSleep (unsigned int);
+
+int runGreenBench (const char *);
+
+#endif
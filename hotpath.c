@@ -0,0 +1,124 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the defined functions declared in the hotpath.h header file.
+	Timestamp counter ticks are turned into ns by timing the counter against the
+	monotonic clock from the first timed scope to the report. Every timed call
+	pays for two counter reads, so the sites called every tick look heavier
+	than they are next to those called rarely.
+
+		gcc -O2 -DHOTPATH_TIMERS -o scheduler *.c -lm
+*/
+
+#include "hotpath.h"
+#include <stdlib.h>
+
+
+_Thread_local HotCell hotCell = NULL;
+_Thread_local HotScope_s * hotCurrent = NULL;
+HotCell hotCellList = NULL;
+unsigned long long hotStartTicks; // counter and clock at the first timed scope
+struct timespec hotStartTime;
+
+const char * hotSiteNames[HOT_SITE_COUNT] = {
+	"osLoop",
+	"streamArrivals",
+	"timerInterrupt",
+	"ioTrap",
+	"ioInterrupt",
+	"pseudoISR",
+	"scheduling",
+	"dispatcher",
+	"pseudoIRET",
+	"terminate",
+	"resetMLFQ",
+	"ageMLFQ",
+	"exportMetrics"
+};
+
+
+/*
+	Prints the report to stderr as the process exits.
+*/
+void hotReportAtExit () {
+	hotReport(stderr);
+}
+
+
+/*
+	Gives the calling thread its own cell and pushes it onto the cell list, the
+	same way metrics.c does. The first cell starts the clock the counter is
+	measured against and arranges for the report at exit.
+*/
+HotCell hotRegisterCell () {
+	HotCell cell = calloc(1, sizeof(HotCell_s));
+	if (cell != NULL) {
+		cell->next = __atomic_load_n(&hotCellList, __ATOMIC_ACQUIRE);
+		while (!__atomic_compare_exchange_n(&hotCellList, &cell->next, cell, 0,
+				__ATOMIC_RELEASE, __ATOMIC_ACQUIRE)) {
+			// cell->next now holds the latest head, try again
+		}
+		if (cell->next == NULL) {
+#ifdef HOTPATH_TIMERS
+			hotStartTicks = hotNow();
+#endif
+			clock_gettime(CLOCK_MONOTONIC, &hotStartTime);
+			atexit(hotReportAtExit);
+		}
+	}
+	return cell;
+}
+
+
+/*
+	Prints every site that was timed, summed across threads, with the most self
+	time first. Does nothing if no scope was timed.
+*/
+void hotReport (FILE * out) {
+	unsigned long long calls[HOT_SITE_COUNT] = {0}, self[HOT_SITE_COUNT] = {0}, inclusive[HOT_SITE_COUNT] = {0};
+	unsigned long long selfTotal = 0, elapsedTicks = 0;
+	int order[HOT_SITE_COUNT];
+	struct timespec now;
+	double nsPerTick, elapsedNs;
+	HotCell cell = __atomic_load_n(&hotCellList, __ATOMIC_ACQUIRE);
+	if (cell == NULL) {
+		return;
+	}
+	for (; cell != NULL; cell = cell->next) {
+		for (int i = 0; i < HOT_SITE_COUNT; i++) {
+			calls[i] += cell->calls[i];
+			self[i] += cell->self[i];
+			inclusive[i] += cell->inclusive[i];
+		}
+	}
+#ifdef HOTPATH_TIMERS
+	elapsedTicks = hotNow() - hotStartTicks;
+#endif
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	elapsedNs = (now.tv_sec - hotStartTime.tv_sec) * 1e9 + (now.tv_nsec - hotStartTime.tv_nsec);
+	nsPerTick = elapsedTicks > 0 ? elapsedNs / elapsedTicks : 1.0;
+
+	for (int i = 0; i < HOT_SITE_COUNT; i++) {
+		int j = i;
+		selfTotal += self[i];
+		while (j > 0 && self[order[j - 1]] < self[i]) {
+			order[j] = order[j - 1];
+			j--;
+		}
+		order[j] = i;
+	}
+
+	fprintf(out, "%-16s %12s %12s %7s %12s %10s %10s\r\n", "site", "calls", "self_ms", "self%",
+		"incl_ms", "self_ns", "incl_ns");
+	for (int i = 0; i < HOT_SITE_COUNT; i++) {
+		int site = order[i];
+		if (calls[site] == 0) {
+			continue;
+		}
+		fprintf(out, "%-16s %12llu %12.3f %6.2f%% %12.3f %10.1f %10.1f\r\n", hotSiteNames[site], calls[site],
+			self[site] * nsPerTick / 1e6, selfTotal > 0 ? 100.0 * self[site] / selfTotal : 0.0,
+			inclusive[site] * nsPerTick / 1e6, self[site] * nsPerTick / calls[site],
+			inclusive[site] * nsPerTick / calls[site]);
+	}
+}
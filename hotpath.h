@@ -0,0 +1,134 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the definitions of structs and declarations of functions for the
+	hotpath.c file. A HOT_SCOPE at the top of a block times the rest of the block
+	with the CPU's timestamp counter, into the calling thread's own counters, so
+	it takes no lock. Time is split into the site's own (self) time and the time
+	including every site timed inside it (inclusive), and a table of both is
+	printed to stderr at exit. The timers are only built with HOTPATH_TIMERS
+	defined, e.g. gcc -DHOTPATH_TIMERS; otherwise HOT_SCOPE is empty.
+*/
+
+#ifndef HOTPATH_H
+#define HOTPATH_H
+
+//includes
+#include <stdio.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+
+//enums
+enum hot_site {
+	HOT_OS_LOOP,
+	HOT_STREAM_ARRIVALS,
+	HOT_TIMER_INTERRUPT,
+	HOT_IO_TRAP,
+	HOT_IO_INTERRUPT,
+	HOT_PSEUDO_ISR,
+	HOT_SCHEDULING,
+	HOT_DISPATCHER,
+	HOT_PSEUDO_IRET,
+	HOT_TERMINATE,
+	HOT_RESET_MLFQ,
+	HOT_AGE_MLFQ,
+	HOT_EXPORT_METRICS,
+	HOT_SITE_COUNT
+};
+
+
+//structs
+/* One thread's totals, in timestamp counter ticks. Only the owning thread writes to a cell. */
+typedef struct hot_cell {
+	unsigned long long calls[HOT_SITE_COUNT];
+	unsigned long long self[HOT_SITE_COUNT];
+	unsigned long long inclusive[HOT_SITE_COUNT];
+	struct hot_cell * next;
+} HotCell_s;
+
+typedef HotCell_s * HotCell;
+
+/* A timed block in progress, on the stack of the function it times. */
+typedef struct hot_scope {
+	enum hot_site site;
+	unsigned long long start;
+	unsigned long long children; // ticks spent in the scopes opened inside this one
+	struct hot_scope * parent;
+} HotScope_s;
+
+
+//declarations
+HotCell hotRegisterCell ();
+
+void hotReport (FILE *);
+
+
+//defines
+#ifdef HOTPATH_TIMERS
+
+extern _Thread_local HotCell hotCell;
+extern _Thread_local HotScope_s * hotCurrent;
+
+/* Times the rest of the enclosing block as the given site, e.g. HOT_SCOPE(DISPATCHER). */
+#define HOT_SCOPE(site) HotScope_s hotScope_##site __attribute__((cleanup(hotLeave))); \
+	hotEnter(&hotScope_##site, HOT_##site)
+
+/*
+	Reads the timestamp counter, or the monotonic clock in ns where there is no
+	TSC; hotReport converts either to ns against the clock.
+*/
+static inline unsigned long long hotNow () {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000000ULL + now.tv_nsec;
+#endif
+}
+
+static inline void hotEnter (HotScope_s * scope, enum hot_site site) {
+	if (__builtin_expect(hotCell == NULL, 0)) {
+		hotCell = hotRegisterCell();
+	}
+	scope->site = site;
+	scope->children = 0;
+	scope->parent = hotCurrent;
+	hotCurrent = scope;
+	scope->start = hotNow();
+}
+
+/*
+	Called as the scope goes out of scope. A site timed inside itself only adds
+	the outermost call to its inclusive time, so it is not counted twice.
+*/
+static inline void hotLeave (HotScope_s * scope) {
+	unsigned long long elapsed = hotNow() - scope->start;
+	HotScope_s * outer;
+	hotCurrent = scope->parent;
+	if (hotCell == NULL) {
+		return;
+	}
+	hotCell->calls[scope->site]++;
+	hotCell->self[scope->site] += elapsed - scope->children;
+	for (outer = scope->parent; outer != NULL && outer->site != scope->site; outer = outer->parent) {
+	}
+	if (outer == NULL) {
+		hotCell->inclusive[scope->site] += elapsed;
+	}
+	if (scope->parent != NULL) {
+		scope->parent->children += elapsed;
+	}
+}
+
+#else
+
+#define HOT_SCOPE(site)
+
+#endif
+
+#endif
@@ -0,0 +1,215 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the defined functions declared in the latency_stats.h header file.
+	Every histogram is allocated statically, so recording a terminated process is a
+	handful of array increments and never calls malloc.
+*/
+
+#include "latency_stats.h"
+#include <string.h>
+
+
+LatencyHist_s latency[LAT_METRIC_COUNT][NUM_PRIORITIES][JOB_CLASS_COUNT];
+LatencyHist_s latencyScratch;
+
+const char * metricNames[LAT_METRIC_COUNT] = {"turnaround", "response", "waiting"};
+const char * classNames[JOB_CLASS_COUNT] = {"cpu", "io"};
+
+
+/*
+	Finds the bucket for the given value. Small values map straight onto their own
+	bucket, larger ones keep the top HIST_SUB_BITS bits of the value.
+*/
+int histBucket (unsigned int value) {
+	int msb, exp;
+	if (value < HIST_SUB_COUNT) {
+		return value;
+	}
+	msb = 31 - __builtin_clz(value);
+	exp = msb - (HIST_SUB_BITS - 1);
+	return exp * HIST_HALF_COUNT + (value >> exp);
+}
+
+
+/*
+	Returns the highest value that falls into the given bucket.
+*/
+unsigned int histBucketValue (int bucket) {
+	int exp;
+	unsigned long long mantissa;
+	if (bucket < HIST_SUB_COUNT) {
+		return bucket;
+	}
+	exp = bucket / HIST_HALF_COUNT - 1;
+	mantissa = bucket % HIST_HALF_COUNT + HIST_HALF_COUNT;
+	return (unsigned int) (((mantissa + 1) << exp) - 1);
+}
+
+
+/*
+	Empties the given histogram.
+*/
+void histReset (LatencyHist hist) {
+	memset(hist, 0, sizeof(LatencyHist_s));
+}
+
+
+/*
+	Adds one sample to the given histogram.
+*/
+void histRecord (LatencyHist hist, unsigned int value) {
+	hist->counts[histBucket(value)]++;
+	hist->total++;
+	hist->sum += value;
+	if (value > hist->max) {
+		hist->max = value;
+	}
+}
+
+
+/*
+	Adds every sample in src into dest. Histograms always have the same buckets,
+	so merging is a plain element-wise add.
+*/
+void histMerge (LatencyHist dest, LatencyHist src) {
+	for (int i = 0; i < HIST_BUCKETS; i++) {
+		dest->counts[i] += src->counts[i];
+	}
+	dest->total += src->total;
+	dest->sum += src->sum;
+	if (src->max > dest->max) {
+		dest->max = src->max;
+	}
+}
+
+
+/*
+	Returns the value at the given percentile (0 to 100). The answer is the top of
+	the bucket the percentile lands in, capped at the largest value recorded.
+*/
+unsigned int histValueAtPercentile (LatencyHist hist, double percentile) {
+	unsigned long long target, seen = 0;
+	unsigned int value;
+	if (hist->total == 0) {
+		return 0;
+	}
+	target = (unsigned long long) (percentile / 100.0 * hist->total + 0.5);
+	if (target < 1) {
+		target = 1;
+	}
+	for (int i = 0; i < HIST_BUCKETS; i++) {
+		seen += hist->counts[i];
+		if (seen >= target) {
+			value = histBucketValue(i);
+			return value < hist->max ? value : hist->max;
+		}
+	}
+	return hist->max;
+}
+
+
+/*
+	Returns the mean of every recorded value, 0 if the histogram is empty.
+*/
+double histMean (LatencyHist hist) {
+	if (hist->total == 0) {
+		return 0.0;
+	}
+	return (double) hist->sum / hist->total;
+}
+
+
+/*
+	A PCB is I/O bound if, on average, it ran for less than IO_BOUND_BURST ticks
+	between I/O traps.
+*/
+enum job_class classifyJob (PCB pcb) {
+	if (pcb->user_ticks < IO_BOUND_BURST * (pcb->io_count + 1)) {
+		return JOB_IO_BOUND;
+	}
+	return JOB_CPU_BOUND;
+}
+
+
+/*
+	Empties every latency histogram.
+*/
+void latencyReset () {
+	memset(latency, 0, sizeof(latency));
+}
+
+
+/*
+	Records the turnaround, response and waiting times of a PCB that has just
+	terminated, under its final priority level and its job class.
+*/
+void latencyRecordTermination (PCB pcb) {
+	enum job_class jobClass = classifyJob(pcb);
+	int level = pcb->priority < NUM_PRIORITIES ? pcb->priority : NUM_PRIORITIES - 1;
+	histRecord(&latency[LAT_TURNAROUND][level][jobClass], pcb->termination - pcb->creation);
+	histRecord(&latency[LAT_RESPONSE][level][jobClass], pcb->first_run - pcb->creation);
+	histRecord(&latency[LAT_WAITING][level][jobClass], pcb->ready_ticks);
+}
+
+
+/*
+	Returns the histogram for one metric, priority level and job class.
+*/
+LatencyHist latencyHist (enum latency_metric metric, int level, enum job_class jobClass) {
+	return &latency[metric][level][jobClass];
+}
+
+
+/*
+	Merges every job class of the given metric into dest. A level of -1 merges
+	every level as well.
+*/
+void latencyMergeAll (enum latency_metric metric, int level, LatencyHist dest) {
+	for (int i = 0; i < NUM_PRIORITIES; i++) {
+		if (level == -1 || level == i) {
+			for (int c = 0; c < JOB_CLASS_COUNT; c++) {
+				histMerge(dest, &latency[metric][i][c]);
+			}
+		}
+	}
+}
+
+
+/*
+	Prints one row of the latency report.
+*/
+void printLatencyRow (FILE * out, const char * metric, const char * level, const char * jobClass, LatencyHist hist) {
+	fprintf(out, "%-10s %5s %5s %7llu %9.1f %7u %7u %7u %7u %7u\r\n", metric, level, jobClass,
+		hist->total, histMean(hist), histValueAtPercentile(hist, 50.0),
+		histValueAtPercentile(hist, 90.0), histValueAtPercentile(hist, 99.0),
+		histValueAtPercentile(hist, 99.9), hist->max);
+}
+
+
+/*
+	Prints the end of run latency report. For each metric there is a row covering
+	every terminated PCB, followed by a row for every final level and job class
+	that had at least one PCB.
+*/
+void latencyReport (FILE * out) {
+	char level[8];
+	fprintf(out, "\r\nLatency report (ticks)\r\n");
+	fprintf(out, "%-10s %5s %5s %7s %9s %7s %7s %7s %7s %7s\r\n", "metric", "level", "class",
+		"count", "mean", "p50", "p90", "p99", "p99.9", "max");
+	for (int m = 0; m < LAT_METRIC_COUNT; m++) {
+		histReset(&latencyScratch);
+		latencyMergeAll(m, -1, &latencyScratch);
+		printLatencyRow(out, metricNames[m], "all", "all", &latencyScratch);
+		for (int i = 0; i < NUM_PRIORITIES; i++) {
+			for (int c = 0; c < JOB_CLASS_COUNT; c++) {
+				if (latency[m][i][c].total) {
+					sprintf(level, "%d", i);
+					printLatencyRow(out, metricNames[m], level, classNames[c], &latency[m][i][c]);
+				}
+			}
+		}
+	}
+	fprintf(out, "\r\n");
+}
@@ -0,0 +1,80 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the definitions of structs and declarations of functions for the
+	latency_stats.c file. It collects per-process turnaround, response and waiting
+	times into HDR-style histograms so the end of a run can report percentiles.
+*/
+
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+//includes
+#include "pcb.h"
+#include <stdio.h>
+
+
+//defines
+#define HIST_SUB_BITS 5
+#define HIST_SUB_COUNT (1 << HIST_SUB_BITS)
+#define HIST_HALF_COUNT (HIST_SUB_COUNT / 2)
+#define HIST_BUCKETS ((32 - HIST_SUB_BITS + 1) * HIST_HALF_COUNT + HIST_HALF_COUNT)
+#define IO_BOUND_BURST 100
+
+
+//enums
+enum latency_metric {
+	LAT_TURNAROUND,
+	LAT_RESPONSE,
+	LAT_WAITING,
+	LAT_METRIC_COUNT
+};
+
+enum job_class {
+	JOB_CPU_BOUND,
+	JOB_IO_BOUND,
+	JOB_CLASS_COUNT
+};
+
+
+//structs
+/*
+	A log-linear histogram. Values below HIST_SUB_COUNT get a bucket each, after that
+	every power of two is split into HIST_HALF_COUNT buckets. A value is reported as
+	the top of its bucket, which is at most 1/HIST_HALF_COUNT (6.25%) above it.
+*/
+typedef struct latency_hist {
+	unsigned long long counts[HIST_BUCKETS];
+	unsigned long long total;
+	unsigned long long sum;
+	unsigned int max;
+} LatencyHist_s;
+
+typedef LatencyHist_s * LatencyHist;
+
+
+//declarations
+void histReset (LatencyHist);
+
+void histRecord (LatencyHist, unsigned int);
+
+void histMerge (LatencyHist, LatencyHist);
+
+unsigned int histValueAtPercentile (LatencyHist, double);
+
+double histMean (LatencyHist);
+
+enum job_class classifyJob (PCB);
+
+void latencyReset ();
+
+void latencyRecordTermination (PCB);
+
+LatencyHist latencyHist (enum latency_metric, int, enum job_class);
+
+void latencyMergeAll (enum latency_metric, int, LatencyHist);
+
+void latencyReport (FILE *);
+
+#endif
@@ -0,0 +1,241 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the defined functions declared in the macrobench.h header file.
+	Every scenario runs with the same seed, for the same ticks, with logging and
+	the metrics file off, and on the settings given with -c and -o, so the
+	queue kind or any other setting can be benchmarked too. The results are
+	printed and written to a CSV file, and given a file from an earlier build,
+	each is compared against it:
+
+		scheduler -M before.csv
+		scheduler -M after.csv -B before.csv -T 5
+
+	The comparison columns are how much worse each measure got, so a positive
+	change is a slowdown or more memory. Each run is made in a child process,
+	so one scenario's memory does not count towards the next one's peak, and
+	none of them leave anything behind here.
+*/
+
+#include "macrobench.h"
+#include "scheduler.h"
+#include <limits.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+
+const MacroScenario_s macroScenarios[] = {
+	{"cpu", "rate=0.002,size=lognormal,io=0.5"},
+	{"io", "rate=0.002,size=lognormal,io=40"},
+	{"mixed", "arrival=mmpp,size=pareto,alpha=1.5,io=8"},
+	{"large", "rate=0.02,size=lognormal,io=8"}, // far past saturation, the MLFQ grows to tens of thousands
+};
+
+
+/*
+	Returns how many times the scheduler has been entered: every timer and I/O
+	interrupt, I/O trap and termination.
+*/
+unsigned long long schedulingDecisions () {
+	return metricsCounter(MET_TIMER_INTERRUPTS) + metricsCounter(MET_IO_TRAPS)
+		+ metricsCounter(MET_IO_INTERRUPTS) + metricsCounter(MET_TERMINATIONS);
+}
+
+
+/*
+	Runs the scenario once in this process, which must be a child of the
+	benchmark, writes what it measured to fd and exits.
+*/
+void macroChild (const MacroScenario_s * scenario, int fd) {
+	Generator_s settings;
+	MacroResult_s result;
+	struct timespec start, end;
+	struct rusage usage;
+	unsigned long long before;
+
+	// the files belong to the parent
+	traceDetach();
+	flameDetach();
+	if (recorder != NULL) {
+		recorderDetach(recorder);
+		recorder = NULL;
+	}
+	replay = NULL;
+	checkpointPath = NULL;
+	whatIf.count = 0;
+
+	generatorInit(&settings);
+	generatorParse(&settings, scenario->generator);
+	resetSimulation();
+	rngSeed(MACROBENCH_SEED);
+	generator = &settings;
+	arrivalLimit = INT_MAX;
+	tickLimit = MACROBENCH_TICKS;
+	logEnabled = 0;
+	metricsPath = NULL;
+
+	before = schedulingDecisions();
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	osLoop();
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	getrusage(RUSAGE_SELF, &usage);
+
+	memset(&result, 0, sizeof(result));
+	snprintf(result.name, sizeof(result.name), "%s", scenario->name);
+	result.ticks = sim_tick;
+	result.decisions = schedulingDecisions() - before;
+	result.seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+	result.ticks_per_sec = result.ticks / result.seconds;
+	result.decisions_per_sec = result.decisions / result.seconds;
+	result.peak_kb = usage.ru_maxrss;
+	_exit(write(fd, &result, sizeof(result)) == sizeof(result) ? 0 : 1);
+}
+
+
+/*
+	Runs the scenario MACROBENCH_REPEATS times and fills in result with the
+	fastest run, and the largest peak of them all. Returns 1 on success, 0 if a
+	run could not be made or did not finish.
+*/
+int runMacroScenario (const MacroScenario_s * scenario, MacroResult_s * result) {
+	long peak = 0;
+	fflush(NULL);
+	for (int i = 0; i < MACROBENCH_REPEATS; i++) {
+		MacroResult_s run;
+		int fd[2], status = 1, ok;
+		pid_t pid;
+		if (pipe(fd) != 0) {
+			return 0;
+		}
+		pid = fork();
+		if (pid == 0) {
+			close(fd[0]);
+			macroChild(scenario, fd[1]);
+		}
+		close(fd[1]);
+		if (pid < 0) {
+			close(fd[0]);
+			return 0;
+		}
+		ok = read(fd[0], &run, sizeof(run)) == sizeof(run);
+		close(fd[0]);
+		if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0 || !ok) {
+			return 0;
+		}
+		if (i == 0 || run.seconds < result->seconds) {
+			*result = run;
+		}
+		if (run.peak_kb > peak) {
+			peak = run.peak_kb;
+		}
+	}
+	result->peak_kb = peak;
+	return 1;
+}
+
+
+/*
+	Reads the rows of a results file written by runMacrobench into results, at
+	most max of them. Returns how many were read, or -1 if it can not be opened.
+*/
+int loadMacroResults (const char * path, MacroResult_s * results, int max) {
+	char line[CONFIG_MAX_LINE];
+	int count = 0;
+	FILE * in = fopen(path, "r");
+	if (in == NULL) {
+		return -1;
+	}
+	while (count < max && fgets(line, sizeof(line), in) != NULL) {
+		MacroResult_s * row = &results[count];
+		if (sscanf(line, "%15[^,],%u,%llu,%lf,%lf,%lf,%ld", row->name, &row->ticks, &row->decisions,
+				&row->seconds, &row->ticks_per_sec, &row->decisions_per_sec, &row->peak_kb) == 7) {
+			count++;
+		}
+	}
+	fclose(in);
+	return count;
+}
+
+
+/*
+	Prints how much worse value is than the baseline's, as a percentage that is
+	positive when it got worse, and returns 1 if that is beyond threshold.
+	A rate is worse when lower, memory when higher.
+*/
+int printChange (double value, double base, int higherIsWorse, double threshold) {
+	double worse;
+	if (base <= 0) {
+		printf(" %8s", "-");
+		return 0;
+	}
+	worse = 100.0 * (higherIsWorse ? value - base : base - value) / base;
+	printf(" %+7.1f%%", worse);
+	return worse > threshold;
+}
+
+
+/*
+	Runs every scenario, prints the results and writes them to path as CSV.
+	Given baselinePath, each result is compared against the row of the same
+	scenario there, and the columns show how much worse it got. Returns 1 on
+	success, 0 if a file could not be opened, a scenario failed, or a result was
+	worse than its baseline by more than threshold percent.
+*/
+int runMacrobench (const char * path, const char * baselinePath, double threshold) {
+	MacroResult_s baseline[MACROBENCH_MAX_ROWS];
+	int baselineCount = 0, regressions = 0;
+	FILE * out;
+
+	if (baselinePath != NULL) {
+		baselineCount = loadMacroResults(baselinePath, baseline, MACROBENCH_MAX_ROWS);
+		if (baselineCount < 0) {
+			fprintf(stderr, "Could not open %s\r\n", baselinePath);
+			return 0;
+		}
+	}
+	out = fopen(path, "w");
+	if (out == NULL) {
+		fprintf(stderr, "Could not open %s\r\n", path);
+		return 0;
+	}
+	fprintf(out, "scenario,ticks,decisions,seconds,ticks_per_sec,decisions_per_sec,peak_rss_kb\n");
+	printf("%-8s %9s %10s %8s %12s %12s %9s%s\r\n", "scenario", "ticks", "decisions", "seconds",
+		"ticks/s", "decisions/s", "peak_kb", baselinePath != NULL ? "   ticks/s decisions/s   peak_kb" : "");
+
+	for (size_t s = 0; s < sizeof(macroScenarios) / sizeof(macroScenarios[0]); s++) {
+		MacroResult_s result;
+		if (!runMacroScenario(&macroScenarios[s], &result)) {
+			fprintf(stderr, "Scenario %s did not finish\r\n", macroScenarios[s].name);
+			fclose(out);
+			return 0;
+		}
+		fprintf(out, "%s,%u,%llu,%.4f,%.1f,%.1f,%ld\n", result.name, result.ticks, result.decisions,
+			result.seconds, result.ticks_per_sec, result.decisions_per_sec, result.peak_kb);
+		printf("%-8s %9u %10llu %8.3f %12.0f %12.0f %9ld", result.name, result.ticks, result.decisions,
+			result.seconds, result.ticks_per_sec, result.decisions_per_sec, result.peak_kb);
+		for (int i = 0; i < baselineCount; i++) {
+			if (strcmp(baseline[i].name, result.name) == 0) {
+				int regressed = printChange(result.ticks_per_sec, baseline[i].ticks_per_sec, 0, threshold);
+				printf("  ");
+				regressed |= printChange(result.decisions_per_sec, baseline[i].decisions_per_sec, 0, threshold);
+				printf(" ");
+				regressed |= printChange(result.peak_kb, baseline[i].peak_kb, 1, threshold);
+				if (regressed) {
+					printf("  regressed");
+					regressions++;
+				}
+				break;
+			}
+		}
+		printf("\r\n");
+	}
+	fclose(out);
+
+	if (regressions > 0) {
+		printf("%d scenario%s worse than %s by more than %.1f%%\r\n", regressions,
+			regressions == 1 ? " is" : "s are", baselinePath, threshold);
+		return 0;
+	}
+	return 1;
+}
@@ -0,0 +1,53 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the definitions of structs and declarations of functions for the
+	macrobench.c file. The macrobenchmark runs whole simulations of a few fixed
+	workloads and measures the simulator itself: simulated ticks and scheduling
+	decisions per second of wall time, and the most memory a run held. Checked
+	against the results of an earlier build, it fails when any of them got worse
+	by more than a threshold, so it can gate a change.
+*/
+
+#ifndef MACROBENCH_H
+#define MACROBENCH_H
+
+//includes
+#include <stdio.h>
+
+
+//defines
+#define MACROBENCH_SEED 1028
+#define MACROBENCH_TICKS 20000000 // ticks each scenario runs for
+#define MACROBENCH_REPEATS 5 // runs of each scenario, the fastest is kept
+#define MACROBENCH_THRESHOLD 10.0 // percent a result may be worse than its baseline
+#define MACROBENCH_MAX_ROWS 32
+
+
+//structs
+typedef struct macro_scenario {
+	const char * name;
+	const char * generator; // settings for generatorParse, on top of the defaults
+} MacroScenario_s;
+
+/* One row of results, as written to the CSV file. */
+typedef struct macro_result {
+	char name[16];
+	unsigned int ticks;
+	unsigned long long decisions; // interrupts, I/O traps and terminations the scheduler handled
+	double seconds;
+	double ticks_per_sec;
+	double decisions_per_sec;
+	long peak_kb; // the largest resident set the run reached
+} MacroResult_s;
+
+
+//declarations
+int runMacroScenario (const MacroScenario_s *, MacroResult_s *);
+
+int loadMacroResults (const char *, MacroResult_s *, int);
+
+int runMacrobench (const char *, const char *, double);
+
+#endif
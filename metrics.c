@@ -0,0 +1,162 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the defined functions declared in the metrics.h header file.
+*/
+
+#include "metrics.h"
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+_Thread_local MetricsCell localCell = NULL;
+MetricsCell cellList = NULL;
+MetricsGauges_s gauges;
+
+const char * counterNames[MET_COUNTER_COUNT] = {
+	"scheduler_context_switches_total",
+	"scheduler_timer_interrupts_total",
+	"scheduler_io_traps_total",
+	"scheduler_io_interrupts_total",
+	"scheduler_io_completions_total",
+	"scheduler_io_coalesce_delay_ticks_total",
+	"scheduler_terminations_total",
+	"scheduler_mlfq_boosts_total",
+	"scheduler_aging_promotions_total"
+};
+
+const char * counterHelp[MET_COUNTER_COUNT] = {
+	"PCBs moved into the running state by the dispatcher.",
+	"Quantum expiries handled by the ISR.",
+	"I/O traps handled by the ISR.",
+	"I/O interrupts handled by the ISR, each waking one or more PCBs.",
+	"PCBs woken by I/O interrupts; less the interrupts, the ISR ticks coalescing saved.",
+	"Ticks completed I/O waited for a coalesced interrupt.",
+	"PCBs moved into the Killed queue.",
+	"Times the MLFQ was reset back to priority 0.",
+	"PCBs moved up one level by aging."
+};
+
+
+/*
+	Gives the calling thread its own cell and pushes it onto the cell list. The
+	push is a compare and swap, so no thread ever waits on another.
+*/
+MetricsCell registerCell () {
+	MetricsCell cell = calloc(1, sizeof(MetricsCell_s));
+	if (cell != NULL) {
+		cell->next = __atomic_load_n(&cellList, __ATOMIC_ACQUIRE);
+		while (!__atomic_compare_exchange_n(&cellList, &cell->next, cell, 0,
+				__ATOMIC_RELEASE, __ATOMIC_ACQUIRE)) {
+			// cell->next now holds the latest head, try again
+		}
+	}
+	return cell;
+}
+
+
+/*
+	Adds one to the given counter in the calling thread's cell. The cell has a single
+	writer, so a relaxed load and store is enough for the exporter to see it.
+*/
+void metricsInc (enum metric_counter counter) {
+	unsigned long long value;
+	if (localCell == NULL) {
+		localCell = registerCell();
+		if (localCell == NULL) {
+			return;
+		}
+	}
+	value = __atomic_load_n(&localCell->counters[counter], __ATOMIC_RELAXED);
+	__atomic_store_n(&localCell->counters[counter], value + 1, __ATOMIC_RELAXED);
+}
+
+
+/*
+	Adds the given amount to the given counter in the calling thread's cell.
+*/
+void metricsAdd (enum metric_counter counter, unsigned long long amount) {
+	unsigned long long value;
+	if (localCell == NULL) {
+		localCell = registerCell();
+		if (localCell == NULL) {
+			return;
+		}
+	}
+	value = __atomic_load_n(&localCell->counters[counter], __ATOMIC_RELAXED);
+	__atomic_store_n(&localCell->counters[counter], value + amount, __ATOMIC_RELAXED);
+}
+
+
+/*
+	Returns the given counter summed across every thread's cell.
+*/
+unsigned long long metricsCounter (enum metric_counter counter) {
+	unsigned long long total = 0;
+	MetricsCell cell = __atomic_load_n(&cellList, __ATOMIC_ACQUIRE);
+	while (cell != NULL) {
+		total += __atomic_load_n(&cell->counters[counter], __ATOMIC_RELAXED);
+		cell = cell->next;
+	}
+	return total;
+}
+
+
+void metricsSetLevels (int levels) {
+	gauges.levels = levels;
+}
+
+
+void metricsSetQueueLength (int level, long long length) {
+	gauges.queue_length[level] = length;
+}
+
+
+void metricsSetBlocked (long long depth) {
+	gauges.blocked = depth;
+}
+
+
+void metricsSetKilled (long long size) {
+	gauges.killed = size;
+}
+
+
+/*
+	Writes every counter and gauge to the given path in the Prometheus text format.
+	The file is written beside the target and renamed over it, so a scraper never
+	reads a half written file. Returns 1 on success, 0 otherwise.
+*/
+int metricsWrite (const char * path) {
+	char tmpPath[PATH_MAX + 4]; // room for ".tmp" after any path
+	FILE * out;
+	if (snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path) >= (int) sizeof(tmpPath)) {
+		return 0; // cut short, it could be the file itself
+	}
+	out = fopen(tmpPath, "w");
+	if (out == NULL) {
+		return 0;
+	}
+	for (int i = 0; i < MET_COUNTER_COUNT; i++) {
+		fprintf(out, "# HELP %s %s\n", counterNames[i], counterHelp[i]);
+		fprintf(out, "# TYPE %s counter\n", counterNames[i]);
+		fprintf(out, "%s %llu\n", counterNames[i], metricsCounter(i));
+	}
+	fprintf(out, "# HELP scheduler_queue_length PCBs waiting in each MLFQ level.\n");
+	fprintf(out, "# TYPE scheduler_queue_length gauge\n");
+	for (int i = 0; i < gauges.levels; i++) {
+		fprintf(out, "scheduler_queue_length{level=\"%d\"} %lld\n", i, gauges.queue_length[i]);
+	}
+	fprintf(out, "# HELP scheduler_blocked_queue_depth PCBs waiting in the Blocked queue.\n");
+	fprintf(out, "# TYPE scheduler_blocked_queue_depth gauge\n");
+	fprintf(out, "scheduler_blocked_queue_depth %lld\n", gauges.blocked);
+	fprintf(out, "# HELP scheduler_killed_queue_size PCBs waiting in the Killed queue.\n");
+	fprintf(out, "# TYPE scheduler_killed_queue_size gauge\n");
+	fprintf(out, "scheduler_killed_queue_size %lld\n", gauges.killed);
+	if (fclose(out) != 0) {
+		return 0;
+	}
+	return rename(tmpPath, path) == 0;
+}
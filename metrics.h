@@ -0,0 +1,74 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the definitions of structs and declarations of functions for the
+	metrics.c file. It keeps the scheduler's counters and gauges and writes them out
+	in the Prometheus text format so long runs can be scraped.
+*/
+
+#ifndef METRICS_H
+#define METRICS_H
+
+//includes
+#include "pcb.h"
+
+
+//defines
+#define METRICS_FILE "scheduler.prom"
+#define METRICS_INTERVAL 1000
+
+
+//enums
+enum metric_counter {
+	MET_CONTEXT_SWITCHES,
+	MET_TIMER_INTERRUPTS,
+	MET_IO_TRAPS,
+	MET_IO_INTERRUPTS,
+	MET_IO_COMPLETIONS,
+	MET_IO_COALESCE_DELAY,
+	MET_TERMINATIONS,
+	MET_MLFQ_BOOSTS,
+	MET_AGING_PROMOTIONS,
+	MET_COUNTER_COUNT
+};
+
+
+//structs
+/*
+	One thread's counters. Only the owning thread writes to a cell, so increments
+	need no lock; the exporter sums every cell on the list.
+*/
+typedef struct metrics_cell {
+	unsigned long long counters[MET_COUNTER_COUNT];
+	struct metrics_cell * next;
+} MetricsCell_s;
+
+typedef MetricsCell_s * MetricsCell;
+
+typedef struct metrics_gauges {
+	int levels; // MLFQ levels in use
+	long long queue_length[NUM_PRIORITIES];
+	long long blocked;
+	long long killed;
+} MetricsGauges_s;
+
+
+//declarations
+void metricsInc (enum metric_counter);
+
+void metricsAdd (enum metric_counter, unsigned long long);
+
+unsigned long long metricsCounter (enum metric_counter);
+
+void metricsSetLevels (int);
+
+void metricsSetQueueLength (int, long long);
+
+void metricsSetBlocked (long long);
+
+void metricsSetKilled (long long);
+
+int metricsWrite (const char *);
+
+#endif
@@ -0,0 +1,606 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the defined functions declared in the microbench.h header file.
+	Every case runs at each size in MICROBENCH_SIZES, and the queue cases on
+	both queue kinds. The results are printed and written to a CSV file, and
+	given a file from an earlier run, each is compared against it:
+
+		scheduler -m before.csv
+		scheduler -m after.csv -B before.csv
+
+	Allocations are counted by wrapping malloc, calloc and realloc. The wrappers
+	would replace them for every run of the binary, not just the benchmark, so
+	they are only built into a benchmark build, and only on glibc; elsewhere
+	allocations are left out like missing hardware counters.
+
+		gcc -O2 -DMICROBENCH_ALLOCS -o scheduler *.c -lm -lpthread
+*/
+
+#include "microbench.h"
+#include "scheduler.h"
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+
+
+volatile unsigned long long benchSink; // keeps the results of the timed calls alive
+_Thread_local unsigned long long allocCount = 0;
+
+#if defined(MICROBENCH_ALLOCS) && defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+#define MICROBENCH_COUNTS_ALLOCS
+
+extern void * __libc_malloc (size_t);
+extern void * __libc_calloc (size_t, size_t);
+extern void * __libc_realloc (void *, size_t);
+
+void * malloc (size_t size) {
+	allocCount++;
+	return __libc_malloc(size);
+}
+
+void * calloc (size_t count, size_t size) {
+	allocCount++;
+	return __libc_calloc(count, size);
+}
+
+void * realloc (void * block, size_t size) {
+	allocCount++;
+	return __libc_realloc(block, size);
+}
+#endif
+
+
+/*
+	Empties the created queue and the MLFQ without touching the PCBs, which
+	belong to the benchmark and not to the queues.
+*/
+void emptyState (BenchState state) {
+	PCB batch[PCB_BATCH];
+	while (q_dequeue_n(state->scheduler->created, batch, PCB_BATCH) > 0) {
+	}
+	for (int i = 0; i < NUM_PRIORITIES; i++) {
+		while (q_dequeue_n(state->scheduler->ready->queues[i], batch, PCB_BATCH) > 0) {
+		}
+	}
+}
+
+
+/*
+	Puts every PCB in the created queue.
+*/
+void fillCreated (BenchState state) {
+	emptyState(state);
+	q_enqueue_batch(state->scheduler->created, state->pcbs, state->count);
+}
+
+
+/*
+	Gives the PCBs priorities spread over every level but the first, with the
+	queues left empty.
+*/
+void spreadPriorities (BenchState state) {
+	int levels = state->scheduler->ready->levels;
+	emptyState(state);
+	for (unsigned int i = 0; i < state->count; i++) {
+		state->pcbs[i]->priority = levels > 1 ? 1 + i % (levels - 1) : 0;
+	}
+}
+
+
+/*
+	Puts the PCBs in the MLFQ, spread over every level but the first.
+*/
+void spreadReady (BenchState state) {
+	spreadPriorities(state);
+	pq_enqueue_batch(state->scheduler->ready, state->pcbs, state->count);
+}
+
+
+/*
+	Puts every PCB on the last level of the MLFQ, so every search of it looks
+	at every level.
+*/
+void lastLevel (BenchState state) {
+	emptyState(state);
+	for (unsigned int i = 0; i < state->count; i++) {
+		state->pcbs[i]->priority = state->scheduler->ready->levels - 1;
+	}
+	pq_enqueue_batch(state->scheduler->ready, state->pcbs, state->count);
+}
+
+
+/*
+	Destroys the PCBs a round made with PCB_create.
+*/
+void destroyMade (BenchState state) {
+	for (unsigned int i = 0; i < state->count; i++) {
+		if (state->pcbs[i] != &state->storage[i]) {
+			PCB_destroy(state->pcbs[i]);
+			state->pcbs[i] = &state->storage[i];
+		}
+	}
+}
+
+
+/*
+	Makes every PCB with PCB_create, unless it already was.
+*/
+void makePCBs (BenchState state) {
+	for (unsigned int i = 0; i < state->count; i++) {
+		if (state->pcbs[i] == &state->storage[i]) {
+			state->pcbs[i] = PCB_create();
+		}
+	}
+}
+
+
+/*
+	Starts the wheel empty at tick 0, with none of the timers set.
+*/
+void emptyWheel (BenchState state) {
+	twInit(state->wheel, 0);
+	memset(state->timers, 0, state->count * sizeof(TimerNode_s));
+}
+
+
+/*
+	Returns the deadline of the given timer, spread over MICROBENCH_TIMER_SPAN
+	ticks so that every level of the wheel is used.
+*/
+unsigned int timerDeadline (unsigned int i) {
+	return 1 + (i * 2654435761u) % MICROBENCH_TIMER_SPAN;
+}
+
+
+void addTimersRound (BenchState state) {
+	for (unsigned int i = 0; i < state->count; i++) {
+		twAdd(state->wheel, &state->timers[i], timerDeadline(i));
+	}
+}
+
+
+/*
+	Sets every timer in an empty wheel.
+*/
+void armTimers (BenchState state) {
+	emptyWheel(state);
+	addTimersRound(state);
+}
+
+
+void cancelTimersRound (BenchState state) {
+	for (unsigned int i = 0; i < state->count; i++) {
+		twCancel(state->wheel, &state->timers[i]);
+	}
+}
+
+
+/*
+	Every timer goes off, with each one moved down as often as its level takes.
+*/
+void expireTimersRound (BenchState state) {
+	twAdvance(state->wheel, MICROBENCH_TIMER_SPAN, NULL, NULL);
+	benchSink += state->wheel->count;
+}
+
+
+void enqueueRound (BenchState state) {
+	for (unsigned int i = 0; i < state->count; i++) {
+		q_enqueue(state->scheduler->created, state->pcbs[i]);
+	}
+}
+
+
+void dequeueRound (BenchState state) {
+	for (unsigned int i = 0; i < state->count; i++) {
+		benchSink += q_dequeue(state->scheduler->created) != NULL;
+	}
+}
+
+
+void peekRound (BenchState state) {
+	for (unsigned int i = 0; i < state->count; i++) {
+		benchSink += q_peek(state->scheduler->created) != NULL;
+	}
+}
+
+
+/*
+	Round robin: the front of a full queue moves to its back, count times.
+*/
+void cycleRound (BenchState state) {
+	for (unsigned int i = 0; i < state->count; i++) {
+		q_enqueue(state->scheduler->created, q_dequeue(state->scheduler->created));
+	}
+}
+
+
+/*
+	Admission: arrivals go into the created queue, then on into the MLFQ.
+*/
+void admitSingle (BenchState state) {
+	enqueueRound(state);
+	while (!q_is_empty(state->scheduler->created)) {
+		pq_enqueue(state->scheduler->ready, q_dequeue(state->scheduler->created));
+	}
+}
+
+
+void admitBatch (BenchState state) {
+	PCB batch[PCB_BATCH];
+	unsigned int taken;
+	q_enqueue_batch(state->scheduler->created, state->pcbs, state->count);
+	while ((taken = q_dequeue_n(state->scheduler->created, batch, PCB_BATCH)) > 0) {
+		pq_enqueue_batch(state->scheduler->ready, batch, taken);
+	}
+}
+
+
+/*
+	Boost: every PCB below level 0 moves up to level 0.
+*/
+void boostSingle (BenchState state) {
+	PriorityQueue ready = state->scheduler->ready;
+	for (int i = 1; i < ready->levels; i++) {
+		while (!q_is_empty(ready->queues[i])) {
+			PCB pcb = q_dequeue(ready->queues[i]);
+			pcb->priority = 0;
+			pcb->quantum_remaining = 0;
+			q_enqueue(ready->queues[0], pcb);
+		}
+	}
+}
+
+
+void boostBatch (BenchState state) {
+	PriorityQueue ready = state->scheduler->ready;
+	for (int i = 1; i < ready->levels; i++) {
+		resetReadyQueue(ready->queues[i]);
+		q_splice(ready->queues[0], ready->queues[i]);
+	}
+}
+
+
+/*
+	Reaping: every PCB is taken off a queue.
+*/
+void drainSingle (BenchState state) {
+	while (q_dequeue(state->scheduler->created) != NULL) {
+	}
+}
+
+
+void drainBatch (BenchState state) {
+	PCB batch[PCB_BATCH];
+	while (q_dequeue_n(state->scheduler->created, batch, PCB_BATCH) > 0) {
+	}
+}
+
+
+void pqEnqueueRound (BenchState state) {
+	for (unsigned int i = 0; i < state->count; i++) {
+		pq_enqueue(state->scheduler->ready, state->pcbs[i]);
+	}
+}
+
+
+void pqDequeueRound (BenchState state) {
+	for (unsigned int i = 0; i < state->count; i++) {
+		benchSink += pq_dequeue(state->scheduler->ready) != NULL;
+	}
+}
+
+
+void pqPeekRound (BenchState state) {
+	for (unsigned int i = 0; i < state->count; i++) {
+		benchSink += pq_peek(state->scheduler->ready) != NULL;
+	}
+}
+
+
+void pqIsEmptyRound (BenchState state) {
+	for (unsigned int i = 0; i < state->count; i++) {
+		benchSink += pq_is_empty(state->scheduler->ready);
+	}
+}
+
+
+void nextQuantumRound (BenchState state) {
+	for (unsigned int i = 0; i < state->count; i++) {
+		benchSink += getNextQuantumSize(state->scheduler->ready);
+	}
+}
+
+
+void createRound (BenchState state) {
+	for (unsigned int i = 0; i < state->count; i++) {
+		state->pcbs[i] = PCB_create();
+	}
+}
+
+
+void destroyRound (BenchState state) {
+	for (unsigned int i = 0; i < state->count; i++) {
+		PCB_destroy(state->pcbs[i]);
+		state->pcbs[i] = &state->storage[i];
+	}
+}
+
+
+void ioTrapRound (BenchState state) {
+	for (unsigned int i = 0; i < state->count; i++) {
+		benchSink += ioTrap(state->pcbs[i]);
+	}
+}
+
+
+void resetRound (BenchState state) {
+	resetMLFQ(state->scheduler);
+}
+
+
+const BenchCase_s benchCases[] = {
+	{"queue", "q_enqueue", emptyState, enqueueRound, NULL, 1, 1},
+	{"queue", "q_dequeue", fillCreated, dequeueRound, NULL, 1, 1},
+	{"queue", "q_peek", fillCreated, peekRound, NULL, 1, 1},
+	{"queue", "q_cycle", fillCreated, cycleRound, NULL, 1, 1},
+	{"batch", "admit_single", emptyState, admitSingle, NULL, 1, 1},
+	{"batch", "admit_batch", emptyState, admitBatch, NULL, 1, 1},
+	{"batch", "boost_single", spreadReady, boostSingle, NULL, 1, 1},
+	{"batch", "boost_batch", spreadReady, boostBatch, NULL, 1, 1},
+	{"batch", "drain_single", fillCreated, drainSingle, NULL, 1, 1},
+	{"batch", "drain_batch", fillCreated, drainBatch, NULL, 1, 1},
+	{"pq", "pq_enqueue", spreadPriorities, pqEnqueueRound, NULL, 1, 1},
+	{"pq", "pq_dequeue", spreadReady, pqDequeueRound, NULL, 1, 1},
+	{"pq", "pq_peek", lastLevel, pqPeekRound, NULL, 1, 1},
+	{"pq", "pq_is_empty", lastLevel, pqIsEmptyRound, NULL, 1, 1},
+	{"pq", "getNextQuantumSize", lastLevel, nextQuantumRound, NULL, 1, 1},
+	{"pcb", "PCB_create", destroyMade, createRound, destroyMade, 1, 0},
+	{"pcb", "PCB_destroy", makePCBs, destroyRound, destroyMade, 1, 0},
+	{"pcb", "ioTrap", makePCBs, ioTrapRound, destroyMade, 1, 0},
+	{"scheduler", "resetMLFQ", spreadReady, resetRound, NULL, 0, 1},
+	{"wheel", "twAdd", emptyWheel, addTimersRound, NULL, 1, 0},
+	{"wheel", "twCancel", armTimers, cancelTimersRound, NULL, 1, 0},
+	{"wheel", "twAdvance", armTimers, expireTimersRound, NULL, 1, 0}
+};
+
+
+/*
+	Opens a counter of the given hardware event for the calling thread in user
+	code, stopped. Returns its fd, or -1 if the kernel does not allow it.
+*/
+int perfCounter (unsigned long long event) {
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.size = sizeof(attr);
+	attr.config = event;
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+
+/*
+	Starts or stops the counter, if there is one.
+*/
+void perfSwitch (int counter, int on) {
+	if (counter >= 0) {
+		ioctl(counter, on ? PERF_EVENT_IOC_ENABLE : PERF_EVENT_IOC_DISABLE, 0);
+	}
+}
+
+
+/*
+	Closes the counter and returns what it counted per operation, or
+	MICROBENCH_NONE if there is no counter.
+*/
+double perfClose (int counter, double operations) {
+	long long value;
+	int ok;
+	if (counter < 0) {
+		return MICROBENCH_NONE;
+	}
+	ok = read(counter, &value, sizeof(value)) == sizeof(value);
+	close(counter);
+	return ok ? value / operations : MICROBENCH_NONE;
+}
+
+
+/*
+	Runs the case over count PCBs in queues of the given kind enough times to
+	make MICROBENCH_OPS operations, after one untimed round to warm the caches,
+	the node free list and the ring buffers. Only the rounds are timed and
+	counted, not their setup. Fills in result and returns 1, or returns 0 if
+	the PCBs could not be allocated.
+*/
+int timeCase (const BenchCase_s * benchCase, unsigned int count, enum queue_kind kind, BenchResult_s * result) {
+	BenchState_s state;
+	struct timespec start, end;
+	unsigned int perRound = benchCase->perPCB ? count : 1;
+	unsigned int rounds = count < MICROBENCH_OPS ? MICROBENCH_OPS / count : 1; // setup is paid per PCB either way
+	unsigned long long allocs = 0, before;
+	double elapsed = 0.0, operations;
+	enum queue_kind configured = config.queue_kind;
+	int instructions, misses;
+
+	config.queue_kind = kind;
+	state.scheduler = schedulerConstructor();
+	config.queue_kind = configured;
+	state.count = count;
+	state.storage = calloc(count, sizeof(PCB_s));
+	state.pcbs = malloc(count * sizeof(PCB));
+	state.wheel = malloc(sizeof(TimerWheel_s));
+	state.timers = calloc(count, sizeof(TimerNode_s));
+	if (state.storage == NULL || state.pcbs == NULL || state.wheel == NULL || state.timers == NULL) {
+		free(state.storage);
+		free(state.pcbs);
+		free(state.wheel);
+		free(state.timers);
+		schedulerDeconstructor(state.scheduler);
+		return 0;
+	}
+	for (unsigned int i = 0; i < count; i++) {
+		state.pcbs[i] = &state.storage[i];
+	}
+	benchCase->setup(&state);
+	benchCase->round(&state);
+
+	instructions = perfCounter(PERF_COUNT_HW_INSTRUCTIONS);
+	misses = perfCounter(PERF_COUNT_HW_CACHE_MISSES);
+	for (unsigned int i = 0; i < rounds; i++) {
+		benchCase->setup(&state);
+		perfSwitch(instructions, 1);
+		perfSwitch(misses, 1);
+		before = allocCount;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		benchCase->round(&state);
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		allocs += allocCount - before;
+		perfSwitch(misses, 0);
+		perfSwitch(instructions, 0);
+		elapsed += (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+	}
+
+	operations = (double) rounds * perRound;
+	snprintf(result->group, sizeof(result->group), "%s", benchCase->group);
+	snprintf(result->name, sizeof(result->name), "%s", benchCase->name);
+	snprintf(result->queue, sizeof(result->queue), "%s", !benchCase->kinded ? "-" : kind == Q_RING ? "ring" : "list");
+	result->pcbs = count;
+	result->ns = elapsed / operations;
+#ifdef MICROBENCH_COUNTS_ALLOCS
+	result->allocs = allocs / operations;
+#else
+	result->allocs = MICROBENCH_NONE;
+#endif
+	result->instructions = perfClose(instructions, operations);
+	result->misses = perfClose(misses, operations);
+
+	if (benchCase->teardown != NULL) {
+		benchCase->teardown(&state);
+	}
+	emptyState(&state);
+	schedulerDeconstructor(state.scheduler);
+	free(state.storage);
+	free(state.pcbs);
+	free(state.wheel);
+	free(state.timers);
+	return 1;
+}
+
+
+/*
+	Reads the rows of a results file written by runMicrobench into results, at
+	most max of them. Returns how many were read, or -1 if it can not be opened.
+*/
+int loadBenchResults (const char * path, BenchResult_s * results, int max) {
+	char line[CONFIG_MAX_LINE];
+	int count = 0;
+	FILE * in = fopen(path, "r");
+	if (in == NULL) {
+		return -1;
+	}
+	while (count < max && fgets(line, sizeof(line), in) != NULL) {
+		BenchResult_s * row = &results[count];
+		if (sscanf(line, "%15[^,],%31[^,],%7[^,],%u,%lf", row->group, row->name, row->queue,
+				&row->pcbs, &row->ns) == 5) {
+			count++;
+		}
+	}
+	fclose(in);
+	return count;
+}
+
+
+/*
+	Prints a measurement in a column of the given width, or a dash if it could
+	not be taken.
+*/
+void printMeasure (int width, int precision, double value) {
+	if (value == MICROBENCH_NONE) {
+		printf(" %*s", width, "-");
+	} else {
+		printf(" %*.*f", width, precision, value);
+	}
+}
+
+
+/*
+	Writes a measurement as a CSV field, left empty if it could not be taken.
+*/
+void writeMeasure (FILE * out, double value) {
+	if (value == MICROBENCH_NONE) {
+		fprintf(out, ",");
+	} else {
+		fprintf(out, ",%.4f", value);
+	}
+}
+
+
+/*
+	Runs every case and prints a row for each, with its change from the same row
+	in the baseline file if one is given. Every row is written to path as CSV.
+	Returns 1 on success, 0 if a file could not be opened or a case could not
+	be run.
+*/
+int runMicrobench (const char * path, const char * baselinePath) {
+	static BenchResult_s baseline[MICROBENCH_MAX_ROWS];
+	unsigned int sizes[] = MICROBENCH_SIZES;
+	int baselineCount = 0, savedLog = logEnabled;
+	FILE * out;
+
+	if (baselinePath != NULL) {
+		baselineCount = loadBenchResults(baselinePath, baseline, MICROBENCH_MAX_ROWS);
+		if (baselineCount < 0) {
+			fprintf(stderr, "Could not open %s\r\n", baselinePath);
+			return 0;
+		}
+	}
+	out = fopen(path, "w");
+	if (out == NULL) {
+		fprintf(stderr, "Could not open %s\r\n", path);
+		return 0;
+	}
+	fprintf(out, "group,op,queue,pcbs,ns_per_op,allocs_per_op,instructions_per_op,cache_misses_per_op\n");
+	printf("%-9s %-18s %-5s %7s %10s %9s %10s %9s%s\r\n", "group", "op", "queue", "pcbs", "ns/op",
+		"allocs/op", "instr/op", "misses/op", baselinePath != NULL ? "   change" : "");
+
+	logEnabled = 0;
+	for (size_t c = 0; c < sizeof(benchCases) / sizeof(benchCases[0]); c++) {
+		for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+			for (int kind = Q_LIST; kind <= (benchCases[c].kinded ? Q_RING : Q_LIST); kind++) {
+				BenchResult_s result;
+				if (!timeCase(&benchCases[c], sizes[s], kind, &result)) {
+					fprintf(stderr, "Could not allocate %u PCBs\r\n", sizes[s]);
+					logEnabled = savedLog;
+					fclose(out);
+					return 0;
+				}
+				fprintf(out, "%s,%s,%s,%u,%.4f", result.group, result.name, result.queue, result.pcbs, result.ns);
+				writeMeasure(out, result.allocs);
+				writeMeasure(out, result.instructions);
+				writeMeasure(out, result.misses);
+				fprintf(out, "\n");
+
+				printf("%-9s %-18s %-5s %7u %10.2f", result.group, result.name, result.queue, result.pcbs, result.ns);
+				printMeasure(9, 3, result.allocs);
+				printMeasure(10, 1, result.instructions);
+				printMeasure(9, 3, result.misses);
+				for (int i = 0; i < baselineCount; i++) {
+					if (strcmp(baseline[i].name, result.name) == 0 && strcmp(baseline[i].queue, result.queue) == 0
+							&& baseline[i].pcbs == result.pcbs && baseline[i].ns > 0) {
+						printf(" %+7.1f%%", 100.0 * (result.ns - baseline[i].ns) / baseline[i].ns);
+						break;
+					}
+				}
+				printf("\r\n");
+			}
+		}
+	}
+	logEnabled = savedLog;
+	fclose(out);
+	return 1;
+}
@@ -0,0 +1,77 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the definitions of structs and declarations of functions for the
+	microbench.c file. The microbenchmarks time the queue, PCB and scheduler
+	operations on their own, away from the rest of a run, so a change to one
+	shows up as ns per operation instead of being lost in a whole run. Every
+	operation is also measured in instructions and cache misses where the
+	kernel allows it, and in allocations in a build with MICROBENCH_ALLOCS.
+*/
+
+#ifndef MICROBENCH_H
+#define MICROBENCH_H
+
+//includes
+#include "priority_queue.h"
+#include "timer_wheel.h"
+#include <stdio.h>
+
+
+//defines
+#define MICROBENCH_OPS 2000000 // PCBs each case and size works through, split into as many rounds as that takes
+#define MICROBENCH_SIZES {10, 1000, 100000}
+#define MICROBENCH_MAX_ROWS 512
+#define MICROBENCH_NONE -1.0 // a measurement that could not be taken
+#define MICROBENCH_TIMER_SPAN (1 << 20) // ticks the timer wheel cases spread their timers over
+
+
+//structs
+struct scheduler; // scheduler.h includes this file
+
+/* What every round of a case works on. */
+typedef struct bench_state {
+	struct scheduler * scheduler; // its created queue and MLFQ are the queues under test
+	PCB_s * storage; // count bare PCBs, for the cases that only queue them
+	PCB * pcbs; // the PCBs the round works on
+	TimerWheel wheel; // the wheel the timer cases work on, with count timers
+	TimerNode_s * timers;
+	unsigned int count;
+} BenchState_s;
+
+typedef BenchState_s * BenchState;
+
+typedef void (* BenchRound) (BenchState);
+
+typedef struct bench_case {
+	const char * group;
+	const char * name;
+	BenchRound setup; // puts the state back before each round, untimed
+	BenchRound round; // timed
+	BenchRound teardown; // frees what the rounds made, untimed, or NULL
+	int perPCB; // 1 if a round is count operations, 0 if it is one
+	int kinded; // 1 if the case is run on both queue kinds
+} BenchCase_s;
+
+/* One row of results, as written to the CSV file. */
+typedef struct bench_result {
+	char group[16];
+	char name[32];
+	char queue[8];
+	unsigned int pcbs;
+	double ns; // per operation
+	double allocs;
+	double instructions; // MICROBENCH_NONE without hardware counters
+	double misses;
+} BenchResult_s;
+
+
+//declarations
+int timeCase (const BenchCase_s *, unsigned int, enum queue_kind, BenchResult_s *);
+
+int loadBenchResults (const char *, BenchResult_s *, int);
+
+int runMicrobench (const char *, const char *);
+
+#endif
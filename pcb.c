@@ -4,6 +4,8 @@
  */
 
 #include"pcb.h"
+#include"rng.h"
+#include"sim_log.h"
 #include<stdio.h>
 #include<stdlib.h>
 #include<string.h>
@@ -12,7 +14,7 @@
 int global_largest_PID = 0;
 
 /*
- * Helper function to iniialize PCB data.
+ * Helper function to iniialize PCB data, all but what is drawn from the RNG.
  */
 void initialize_data(/* in-out */ PCB pcb) {
 	pcb->pid = 0;
@@ -35,16 +37,20 @@ void initialize_data(/* in-out */ PCB pcb) {
 	pcb->context->r6 = 0;
 	pcb->context->r7 = 0;
   
-	pcb->max_pc = makeMaxPC();
 	pcb->creation = 0;
 	pcb->termination = 0;
-	pcb->terminate = rand() % MAX_TERM_COUNT;
+	pcb->user_ticks = 0;
+	pcb->system_ticks = 0;
+	pcb->ready_ticks = 0;
+	pcb->blocked_ticks = 0;
+	pcb->quantum_remaining = 0;
+	pcb->quantum_end = 0;
+	pcb->burst_start = 0;
+	pcb->state_since = 0;
+	pcb->level_since = 0;
+	pcb->first_run = -1;
+	pcb->io_count = 0;
 	pcb->term_count = 0;
-  
-	//time_t t;
-	//srand((unsigned) time(&t));
-	populateIOTraps (pcb, 0); // populates io_1_traps
-	populateIOTraps (pcb, 1); // populates io_2_traps
 }
 
 
@@ -58,7 +64,7 @@ void initialize_data(/* in-out */ PCB pcb) {
 void populateIOTraps (PCB pcb, int ioTrapType) {
 	unsigned int newRand = 0;
 	for (int i = 0; i < TRAP_COUNT; i++) {
-		newRand = rand() % pcb->max_pc;
+		newRand = rngArrivalRange(pcb->max_pc);
 		while (ioTrapContains(newRand, pcb->io_1_traps) || ioTrapContains(newRand, pcb->io_2_traps)) {
 			newRand++;
 		}
@@ -98,21 +104,39 @@ int ioTrapContains (unsigned int newRand, unsigned int ioTraps[]) {
 	and returned.
 */
 unsigned int makeMaxPC () {
-	unsigned int maxPC = rand() % LARGEST_PC_POSSIBLE;
-	if (maxPC < SMALLEST_PC_POSSIBLE) maxPC += ((rand() % SMALLEST_PC_POSSIBLE) + SMALLEST_PC_POSSIBLE);
+	unsigned int maxPC = rngArrivalRange(LARGEST_PC_POSSIBLE);
+	if (maxPC < SMALLEST_PC_POSSIBLE) maxPC += (rngArrivalRange(SMALLEST_PC_POSSIBLE) + SMALLEST_PC_POSSIBLE);
 	return maxPC;
 }
 
 
 /*
- * Allocate a PCB and a context for that PCB.
+ * Allocate a PCB and a context for that PCB, with a random max PC, terminate
+ * count and IO traps.
  *
  * Return: NULL if context or PCB allocation failed, the new pointer otherwise.
  */
 PCB PCB_create() {
-    PCB new_pcb = malloc(sizeof(PCB_s));
+    PCB new_pcb = PCB_create_blank();
+    if (new_pcb != NULL) {
+        new_pcb->max_pc = makeMaxPC();
+        new_pcb->terminate = rngArrivalRange(MAX_TERM_COUNT);
+        populateIOTraps (new_pcb, 0); // populates io_1_traps
+        populateIOTraps (new_pcb, 1); // populates io_2_traps
+    }
+    return new_pcb;
+}
+
+/*
+ * Allocate a PCB and a context for that PCB without drawing from the RNG, for
+ * a PCB whose max PC, terminate count and IO traps come from elsewhere.
+ *
+ * Return: NULL if context or PCB allocation failed, the new pointer otherwise.
+ */
+PCB PCB_create_blank() {
+    PCB new_pcb = calloc(1, sizeof(PCB_s)); // zeroed, padding and all, so equal PCBs checkpoint equally
     if (new_pcb != NULL) {
-        new_pcb->context = malloc(sizeof(CPU_context_s));
+        new_pcb->context = calloc(1, sizeof(CPU_context_s));
         if (new_pcb->context != NULL) {
             initialize_data(new_pcb);
 			PCB_assign_PID(new_pcb);
@@ -132,7 +156,7 @@ PCB PCB_create() {
 void PCB_destroy(/* in-out */ PCB pcb) {
 	if (pcb->context) {
 	  free(pcb->context);
-	  printf("breaks\n");
+	  LOG("breaks\n");
 	}
 	  free(pcb);// that thing
 }
@@ -157,6 +181,32 @@ void PCB_assign_state(/* in-out */ PCB the_pcb, /* in */ enum state_type the_sta
     the_pcb->state = the_state;
 }
 
+/*
+ * Moves the process into the provided state at the given tick, charging the time
+ * spent in the previous state to the matching ready or blocked counter. The first
+ * move into the running state is remembered as the process's first_run.
+ *
+ * Arguments: pcb: the pcb to modify.
+ *            state: the new state of the process.
+ *            tick: the current simulation tick.
+ */
+void PCB_transition(/* in-out */ PCB the_pcb, /* in */ enum state_type the_state, /* in */ unsigned int tick) {
+	unsigned int elapsed = tick - the_pcb->state_since;
+	if (the_pcb->state == STATE_READY) {
+		the_pcb->ready_ticks += elapsed;
+	} else if (the_pcb->state == STATE_WAIT) {
+		the_pcb->blocked_ticks += elapsed;
+	}
+	if (the_state == STATE_RUNNING && the_pcb->first_run == (unsigned int) -1) {
+		the_pcb->first_run = tick;
+	}
+	if (the_state == STATE_READY) {
+		the_pcb->level_since = tick;
+	}
+	the_pcb->state = the_state;
+	the_pcb->state_since = tick;
+}
+
 /*
  * Sets the parent of the given pcb to the provided pid.
  *
@@ -188,68 +238,68 @@ void PCB_assign_priority(/* in */ PCB the_pcb, /* in */ unsigned int the_priorit
  * Return: a string representation of the provided PCB on success, NULL otherwise.
  */
 void toStringPCB(PCB thisPCB, int showCpu) {
-	printf("contents: ");
+	LOG("contents: ");
 	
-	printf("PID: %d, ", thisPCB->pid);
+	LOG("PID: %d, ", thisPCB->pid);
 
 	switch(thisPCB->state) {
 		case STATE_NEW:
-			printf("state: new, ");
+			LOG("state: new, ");
 			break;
 		case STATE_READY:
-			printf("state: ready, ");
+			LOG("state: ready, ");
 			break;
 		case STATE_RUNNING:
-			printf("state: running, ");
+			LOG("state: running, ");
 			break;
 		case STATE_INT:
-			printf("state: interrupted, ");
+			LOG("state: interrupted, ");
 			break;
 		case STATE_WAIT:
-			printf("state: waiting, ");
+			LOG("state: waiting, ");
 			break;
 		case STATE_HALT:
-			printf("state: halted, ");
+			LOG("state: halted, ");
 			break;
 	}
 	
-	printf("priority: %d, ", thisPCB->priority);
-	printf("PC: %d, ", thisPCB->context->pc);
+	LOG("priority: %d, ", thisPCB->priority);
+	LOG("PC: %d, ", thisPCB->context->pc);
 	
-	printf("\r\nMAX PC: %d\r\n", thisPCB->max_pc);
-	printf("io_1_traps\n");
+	LOG("\r\nMAX PC: %d\r\n", thisPCB->max_pc);
+	LOG("io_1_traps\n");
 	for (int i = 0; i < TRAP_COUNT; i++) {
-		printf("%d ", thisPCB->io_1_traps[i]);
+		LOG("%d ", thisPCB->io_1_traps[i]);
 	}
-	printf("\r\nio_2_traps\r\n");
+	LOG("\r\nio_2_traps\r\n");
 	for (int i = 0; i < TRAP_COUNT; i++) {
-		printf("%d ", thisPCB->io_2_traps[i]);
+		LOG("%d ", thisPCB->io_2_traps[i]);
 	}
-	printf("\r\nterminate: %d\r\n", thisPCB->terminate);
-	printf("term_count: %d\r\n", thisPCB->term_count);
-	printf("\r\n");
+	LOG("\r\nterminate: %d\r\n", thisPCB->terminate);
+	LOG("term_count: %d\r\n", thisPCB->term_count);
+	LOG("\r\n");
 	
 	if (showCpu) {
-		printf("mem: 0x%04X, ", thisPCB->mem);
-		printf("parent: %d, ", thisPCB->parent);
-		printf("size: %d, ", thisPCB->size);
-		printf("channel_no: %d ", thisPCB->channel_no);
+		LOG("mem: 0x%04X, ", thisPCB->mem);
+		LOG("parent: %d, ", thisPCB->parent);
+		LOG("size: %d, ", thisPCB->size);
+		LOG("channel_no: %d ", thisPCB->channel_no);
 		toStringCPUContext(thisPCB->context);
 	}
 }
 
 
 void toStringCPUContext(CPU_context_p context) {
-	printf(" CPU context values: ");
-	printf("ir:  %d, ", context->ir);
-	printf("psr: %d, ", context->psr);
-	printf("r0:  %d, ", context->r0);
-	printf("r1:  %d, ", context->r1);
-	printf("r2:  %d, ", context->r2);
-	printf("r3:  %d, ", context->r3);
-	printf("r4:  %d, ", context->r4);
-	printf("r5:  %d, ", context->r5);
-	printf("r6:  %d, ", context->r6);
-	printf("r7:  %d\r\n", context->r7);
+	LOG(" CPU context values: ");
+	LOG("ir:  %d, ", context->ir);
+	LOG("psr: %d, ", context->psr);
+	LOG("r0:  %d, ", context->r0);
+	LOG("r1:  %d, ", context->r1);
+	LOG("r2:  %d, ", context->r2);
+	LOG("r3:  %d, ", context->r3);
+	LOG("r4:  %d, ", context->r4);
+	LOG("r5:  %d, ", context->r5);
+	LOG("r6:  %d, ", context->r6);
+	LOG("r7:  %d\r\n", context->r7);
 }
  
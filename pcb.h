@@ -6,7 +6,8 @@
 #ifndef PCB_H  /* Include guard */
 #define PCB_H
 
-#define NUM_PRIORITIES 16
+#define NUM_PRIORITIES 32 // most levels the MLFQ can be configured with
+#define DEFAULT_PRIORITIES 16
 #define TRAP_COUNT 4
 #define LARGEST_PC_POSSIBLE 1000
 #define SMALLEST_PC_POSSIBLE 30
@@ -44,7 +45,7 @@ typedef struct pcb {
     unsigned int pid; // process identification
     enum state_type state; // process state (running, waiting, etc.)
     unsigned int parent; // parent process pid
-    unsigned char priority; // 0 is highest – 15 is lowest.
+    unsigned char priority; // 0 is highest – levels - 1 is lowest.
     unsigned char * mem; // start of process in memory
     unsigned int size; // number of bytes in process
     unsigned char channel_no; // which I/O device or service Q
@@ -56,6 +57,17 @@ typedef struct pcb {
 	unsigned int io_1_traps[TRAP_COUNT];
 	unsigned int io_2_traps[TRAP_COUNT];
 	unsigned int blocked_timer;
+	unsigned int user_ticks; // ticks spent running the process itself
+	unsigned int system_ticks; // ticks spent in the ISR on behalf of the process
+	unsigned int ready_ticks; // ticks spent waiting in the MLFQ
+	unsigned int blocked_ticks; // ticks spent waiting in the Blocked queue
+	unsigned int quantum_remaining; // ticks left in the time slice while off the CPU, 0 for a fresh one
+	unsigned int quantum_end; // user_ticks at which the time slice runs out, while running
+	unsigned int burst_start; // user_ticks when it was last dispatched
+	unsigned int state_since; // tick the current state was entered
+	unsigned int level_since; // tick it joined its MLFQ level, while ready
+	unsigned int first_run; // tick of the first dispatch, -1 until then
+	unsigned int io_count; // number of I/O traps taken
     // if process is blocked, which queue it is in
     CPU_context_p context; // set of cpu registers
     // other items to be added as needed.
@@ -70,6 +82,17 @@ typedef PCB_s * PCB;
  */
 PCB PCB_create();
 
+/*
+ * Allocate a PCB and a context for that PCB, leaving its max PC, terminate
+ * count and IO traps zero and the RNG untouched.
+ *
+ * Return: NULL if context or PCB allocation failed, the new pointer otherwise.
+ */
+PCB PCB_create_blank();
+
+/* The PID the next PCB created gets. */
+extern int global_largest_PID;
+
 /*
  * Frees a PCB and its context.
  *
@@ -92,6 +115,16 @@ void PCB_assign_PID(/* in */ PCB pcb);
  */
 void PCB_assign_state(/* in-out */ PCB pcb, /* in */ enum state_type state);
 
+/*
+ * Moves the process into the provided state at the given tick, charging the time
+ * spent in the previous state to the matching ready or blocked counter.
+ *
+ * Arguments: pcb: the pcb to modify.
+ *            state: the new state of the process.
+ *            tick: the current simulation tick.
+ */
+void PCB_transition(/* in-out */ PCB pcb, /* in */ enum state_type state, /* in */ unsigned int tick);
+
 /*
  * Sets the parent of the given pcb to the provided pid.
  *
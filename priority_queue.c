@@ -8,23 +8,24 @@
 #include <string.h>
 
 #include "priority_queue.h"
+#include "sim_log.h"
 
 #define ADDITIONAL_ROOM_FOR_TOSTR 4
-#define PRIORITY_JUMP_EXTRA 1000
-#define MIN_PRIORITY_JUMP 500
 
 /*
- * Creates a priority queue.
+ * Creates a priority queue whose levels are queues of the given kind.
  *
+ * Arguments: kind: the kind of FIFO queue every level is.
  * Return: A new priority queue on success, NULL on failure.
  */
-PriorityQueue pq_create() {
+PriorityQueue pq_create_kind(enum queue_kind kind) {
     int i, failed = -1;
     PriorityQueue new_pq = malloc(sizeof(PQ_s));
 
     if (new_pq != NULL) {
+        new_pq->levels = DEFAULT_PRIORITIES;
         for (i = 0; i < NUM_PRIORITIES; i++) {
-            new_pq->queues[i] = q_create();
+            new_pq->queues[i] = q_create_kind(kind);
             if (new_pq->queues[i] == NULL) {
                 failed = i;
                 break;
@@ -36,7 +37,7 @@ PriorityQueue pq_create() {
 			}
         }
         /* If failed is non-zero, we need to free up everything else. */
-        for (i = 0; i <= failed; i++) {
+        for (i = 0; i < failed; i++) {
             q_destroy(new_pq->queues[i]);
         }
         /* Simlarly, if it is true, we need to free the priority queue. */
@@ -49,10 +50,31 @@ PriorityQueue pq_create() {
     return new_pq;
 }
 
+/*
+ * Creates a priority queue.
+ *
+ * Return: A new priority queue on success, NULL on failure.
+ */
+PriorityQueue pq_create() {
+    return pq_create_kind(Q_LIST);
+}
+
+
+/*
+ * Sets how many levels of the priority queue are in use. Levels past this are
+ * never searched, so PCBs must not be enqueued into them.
+ *
+ * Arguments: PQ: The Priority Queue to change.
+ *            levels: the number of levels, 1 to NUM_PRIORITIES.
+ */
+void pq_set_levels(PriorityQueue PQ, int levels) {
+    PQ->levels = levels;
+}
+
 
 int getNextQuantumSize (PriorityQueue PQ) {
 	int qSize = 0;
-	for (int i = 0; i < NUM_PRIORITIES; i++) {
+	for (int i = 0; i < PQ->levels; i++) {
 		ReadyQueue curr = PQ->queues[i];
 		if (!q_is_empty(curr)) {
 			qSize = curr->quantum_size;
@@ -88,6 +110,27 @@ void pq_enqueue(PriorityQueue PQ, PCB pcb) {
     q_enqueue(PQ->queues[pcb->priority], pcb);
 }
 
+/*
+ * Enqueues count PCBs, each into its priority bin, keeping their order. Each
+ * run of PCBs with the same priority goes into its bin as one batch.
+ *
+ * Arguments: PQ: The Priority Queue to enqueue to.
+ *            pcbs: the PCBs to enqueue.
+ *            count: how many there are.
+ */
+void pq_enqueue_batch(PriorityQueue PQ, PCB * pcbs, unsigned int count) {
+    unsigned int start = 0;
+
+    while (start < count) {
+        unsigned int end = start + 1;
+        while (end < count && pcbs[end]->priority == pcbs[start]->priority) {
+            end++;
+        }
+        q_enqueue_batch(PQ->queues[pcbs[start]->priority], pcbs + start, end - start);
+        start = end;
+    }
+}
+
 /*
  * Dequeues a PCB from the provided priority queue.
  *
@@ -98,7 +141,7 @@ PCB pq_dequeue(PriorityQueue PQ) {
     int i;
     PCB ret_pcb = NULL;
 
-    for (i = 0; i < NUM_PRIORITIES; i++) {
+    for (i = 0; i < PQ->levels; i++) {
         if (!q_is_empty(PQ->queues[i])) {
             ret_pcb = q_dequeue(PQ->queues[i]);
             break;
@@ -117,7 +160,7 @@ char pq_is_empty(PriorityQueue PQ) {
     int i;
     char ret_val = 1;
 
-    for (i = 0; i < NUM_PRIORITIES; i++) {
+    for (i = 0; i < PQ->levels; i++) {
         /* If a single queue isn't empty, the priority queue isn't empty. */
         if (q_is_empty(PQ->queues[i]) == 0) {
             ret_val = 0;
@@ -140,7 +183,7 @@ char pq_is_empty(PriorityQueue PQ) {
 	int i = 0;
 	
 	if (!pq_is_empty(PQ)) {
-		while (i < NUM_PRIORITIES) {
+		while (i < PQ->levels) {
 			if (!q_is_empty(PQ->queues[i])) {
 				pcb = q_peek(PQ->queues[i]);
 				break;
@@ -159,12 +202,12 @@ char pq_is_empty(PriorityQueue PQ) {
  * Arguments: PQ: the Priority Queue to create a string representation of.
  */
  void toStringPriorityQueue(PriorityQueue PQ) {
-	printf("\r\n");
-	for (int i = 0; i < NUM_PRIORITIES; i++) {
-		printf("Q%2d: Count=%d, QuantumSize=%d\r\n", i, PQ->queues[i]->size, PQ->queues[i]->quantum_size);
+	LOG("\r\n");
+	for (int i = 0; i < PQ->levels; i++) {
+		LOG("Q%2d: Count=%d, QuantumSize=%d\r\n", i, PQ->queues[i]->size, PQ->queues[i]->quantum_size);
 		//toStringReadyQueue(PQ->queues[i]);
 	}
-	printf("\r\n");
+	LOG("\r\n");
  }
  
 /*char * toStringPriorityQueue(PriorityQueue PQ, int display_back) {
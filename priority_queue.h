@@ -9,8 +9,12 @@
 #include "pcb.h"
 #include "fifo_queue.h"
 
+#define PRIORITY_JUMP_EXTRA 1000
+#define MIN_PRIORITY_JUMP 500
+
 typedef struct priority_queue {
     ReadyQueue     queues[NUM_PRIORITIES];
+    int            levels; // queues in use, the rest stay empty
 } PQ_s;
 
 typedef struct priority_queue * PriorityQueue;
@@ -23,6 +27,23 @@ typedef struct priority_queue * PriorityQueue;
  */
 PriorityQueue pq_create();
 
+/*
+ * Creates a priority queue whose levels are queues of the given kind.
+ *
+ * Arguments: kind: the kind of FIFO queue every level is.
+ * Return: A new priority queue on success, NULL on failure.
+ */
+PriorityQueue pq_create_kind(enum queue_kind kind);
+
+/*
+ * Sets how many levels of the priority queue are in use. Levels past this are
+ * never searched, so PCBs must not be enqueued into them.
+ *
+ * Arguments: PQ: The Priority Queue to change.
+ *            levels: the number of levels, 1 to NUM_PRIORITIES.
+ */
+void pq_set_levels(PriorityQueue PQ, int levels);
+
 /*
  * Destroys the provided priority queue, freeing all contents.
  *
@@ -38,6 +59,15 @@ void pq_destroy(PriorityQueue PQ);
  */
 void pq_enqueue(PriorityQueue PQ, PCB pcb);
 
+/*
+ * Enqueues count PCBs, each into its priority bin, keeping their order.
+ *
+ * Arguments: PQ: The Priority Queue to enqueue to.
+ *            pcbs: the PCBs to enqueue.
+ *            count: how many there are.
+ */
+void pq_enqueue_batch(PriorityQueue PQ, PCB * pcbs, unsigned int count);
+
 /*
  * Dequeues a PCB from the provided priority queue.
  *
@@ -0,0 +1,177 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the defined functions declared in the quantum_adapt.h header file.
+	The bursts a level sees depend on its quantum, since the ones it cuts short
+	move their PCBs down, so resizing can make a quantum oscillate. It is held
+	back several ways:
+
+		- the histogram only loses half its weight each period, so older
+		  bursts still count
+		- a change is only made once two periods in a row ask for it
+		- changes within ADAPT_DEADBAND are not made, and a quantum only grows
+		  once the bursts cut short are ADAPT_DEADBAND past their share
+		- a quantum grows by ADAPT_GROW, and shrinks only halfway to its
+		  target on a log scale, by at most ADAPT_STEP
+		- a shrunk quantum keeps ADAPT_HEADROOM past the target, so it does
+		  not cut the next bursts short and grow straight back
+
+	Each level also stays between the quanta of the levels above and below it,
+	so lower levels never get shorter slices.
+*/
+
+#include "quantum_adapt.h"
+#include "config.h"
+#include <math.h>
+#include <string.h>
+
+
+AdaptLevel_s adaptLevels[NUM_PRIORITIES];
+
+
+/*
+	Forgets every burst and every resize.
+*/
+void adaptReset () {
+	memset(adaptLevels, 0, sizeof(adaptLevels));
+}
+
+
+/*
+	Returns the bucket of a burst of the given ticks. Below 4 each length has
+	its own; past that, each power of two is split into four equal parts.
+*/
+int adaptBucket (unsigned int ticks) {
+	int octave;
+	if (ticks < 4) {
+		return ticks;
+	}
+	octave = 31 - __builtin_clz(ticks);
+	return 4 * octave + ((ticks >> (octave - 2)) & 3);
+}
+
+
+/*
+	Returns the first tick past the given bucket, the last one it holds plus one.
+*/
+double adaptBucketEnd (int b) {
+	if (b < 4) {
+		return b + 1;
+	}
+	return ldexp(5 + b % 4, b / 4 - 2);
+}
+
+
+/*
+	Returns the quantum the level's bursts ask for: ADAPT_GROW times the current
+	one if too many were cut short, otherwise the length adapt_target percent
+	of them fit in, plus headroom. The bursts cut short are longer than any
+	that finished, so they are the ones left over past the target.
+*/
+double adaptWanted (AdaptLevel_s * level, double current) {
+	double total = level->cut, seen = 0, fit = config.adapt_target / 100.0;
+	for (int b = 0; b < ADAPT_BUCKETS; b++) {
+		total += level->weight[b];
+	}
+	if (total <= 0) {
+		return current;
+	}
+	if (level->cut > (1.0 - fit) * (1.0 + ADAPT_DEADBAND) * total) {
+		return current * ADAPT_GROW;
+	}
+	for (int b = 0; b < ADAPT_BUCKETS; b++) {
+		if (level->weight[b] > 0 && seen + level->weight[b] >= fit * total) {
+			double low = b ? adaptBucketEnd(b - 1) : 0.0, high = adaptBucketEnd(b);
+			return (low + (high - low) * (fit * total - seen) / level->weight[b]) * ADAPT_HEADROOM;
+		}
+		seen += level->weight[b];
+	}
+	return current;
+}
+
+
+/*
+	Resizes the quantum of the given level from its bursts, if they ask for a
+	big enough change the same way as the last period did, and weights the
+	bursts down.
+*/
+void adaptResize (PriorityQueue ready, int i) {
+	AdaptLevel_s * level = &adaptLevels[i];
+	double current = ready->queues[i]->quantum_size;
+	double wanted = adaptWanted(level, current);
+	double lowest = i > 0 ? ready->queues[i - 1]->quantum_size : ADAPT_MIN_QUANTUM;
+	double highest = i + 1 < ready->levels ? ready->queues[i + 1]->quantum_size : ADAPT_MAX_QUANTUM;
+
+	if (wanted < current) {
+		wanted = fmax(sqrt(wanted * current), current / ADAPT_STEP); // only part of the way down
+	}
+	wanted = fmin(fmax(wanted, fmax(lowest, ADAPT_MIN_QUANTUM)), fmin(highest, ADAPT_MAX_QUANTUM));
+	if (fabs(wanted - current) <= ADAPT_DEADBAND * current) {
+		level->asked = 0;
+	} else if (level->asked != (wanted > current ? 1 : -1)) {
+		level->asked = wanted > current ? 1 : -1;
+	} else {
+		level->quantum = (unsigned int) wanted;
+		setQuantumSize(ready->queues[i], level->quantum);
+		level->resizes++;
+		level->asked = 0;
+	}
+	for (int b = 0; b < ADAPT_BUCKETS; b++) {
+		level->weight[b] *= ADAPT_DECAY;
+	}
+	level->cut *= ADAPT_DECAY;
+	level->pending = 0;
+}
+
+
+/*
+	Counts the CPU burst the PCB has just ended at its level, cut if its
+	quantum ran out before it did, and resizes the level's quantum once
+	ADAPT_PERIOD of them have been counted.
+*/
+void adaptBurst (PriorityQueue ready, PCB pcb, int cut) {
+	AdaptLevel_s * at = &adaptLevels[pcb->priority];
+	unsigned int ticks = pcb->user_ticks - pcb->burst_start;
+	if (cut && pcb->quantum_end - pcb->burst_start - 1 < ready->queues[pcb->priority]->quantum_size) {
+		return;
+	}
+	if (cut) {
+		at->cut += 1.0;
+	} else {
+		at->weight[adaptBucket(ticks)] += 1.0;
+	}
+	at->bursts++;
+	if (++at->pending >= ADAPT_PERIOD) {
+		adaptResize(ready, pcb->priority);
+	}
+}
+
+
+/*
+	Puts back the quanta the levels have been resized to, over the configured
+	ones, as after the MLFQ is reconfigured or restored.
+*/
+void adaptApply (PriorityQueue ready) {
+	for (int i = 0; i < ready->levels; i++) {
+		if (adaptLevels[i].quantum != 0) {
+			setQuantumSize(ready->queues[i], adaptLevels[i].quantum);
+		}
+	}
+}
+
+
+/*
+	Prints the quantum of every level that has seen bursts, next to the one it
+	was configured with.
+*/
+void adaptReport (PriorityQueue ready, FILE * out) {
+	for (int i = 0; i < ready->levels; i++) {
+		AdaptLevel_s * level = &adaptLevels[i];
+		if (level->bursts == 0) {
+			continue;
+		}
+		fprintf(out, "Level %d quantum: %u configured, %u adapted, after %llu bursts and %u resizes\r\n", i,
+			config.quantum[i], ready->queues[i]->quantum_size, level->bursts, level->resizes);
+	}
+}
@@ -0,0 +1,60 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the definitions of structs and declarations of functions for the
+	quantum_adapt.c file. With adaptive_quantum on, the CPU bursts run at each
+	MLFQ level are kept in a histogram of quarter octave buckets, and every
+	ADAPT_PERIOD bursts the level's quantum is resized so that adapt_target
+	percent of them fit inside it. A burst ends when the PCB traps for I/O or
+	terminates; one its quantum cut short is counted as cut, since all that is
+	known is that it needed more. A PCB that resumed with the rest of a slice
+	carried over an I/O trap and ran out of it says nothing about the
+	quantum, so that is not counted at all.
+*/
+
+#ifndef QUANTUM_ADAPT_H
+#define QUANTUM_ADAPT_H
+
+//includes
+#include "priority_queue.h"
+#include <stdio.h>
+
+
+//defines
+#define ADAPT_BUCKETS 128 // four to each power of two, see adaptBucket
+#define ADAPT_PERIOD 64 // bursts at a level between resizes
+#define ADAPT_DECAY 0.5 // what the histogram is weighted by after each resize
+#define ADAPT_GROW 1.5 // what a quantum that cuts too many bursts short grows by
+#define ADAPT_STEP 2.0 // most a quantum shrinks by in one resize
+#define ADAPT_HEADROOM 1.25 // a shrunk quantum is this much past the target burst
+#define ADAPT_DEADBAND 0.25 // changes smaller than this fraction are not made
+#define ADAPT_MIN_QUANTUM 10
+#define ADAPT_MAX_QUANTUM 1000000
+
+
+//structs
+/* What has been seen at one level, and the quantum it came to. */
+typedef struct adapt_level {
+	double weight[ADAPT_BUCKETS]; // finished bursts by length, weighted down every resize
+	double cut; // the weight of bursts a quantum cut short, whose length is not known
+	unsigned int pending; // bursts since the last resize
+	int asked; // what the last period asked for: 1 to grow, -1 to shrink, 0 neither
+	unsigned int quantum; // 0 until the level is first resized
+	unsigned long long bursts;
+	unsigned int resizes;
+} AdaptLevel_s;
+
+
+//declarations
+extern AdaptLevel_s adaptLevels[NUM_PRIORITIES];
+
+void adaptReset ();
+
+void adaptBurst (PriorityQueue, PCB, int);
+
+void adaptApply (PriorityQueue);
+
+void adaptReport (PriorityQueue, FILE *);
+
+#endif
@@ -0,0 +1,126 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the defined functions declared in the rng.h header file. The
+	generator is xorshift64*, which is fast, has a 64 bit state and passes the
+	usual statistical tests, unlike rand() whose range is only 15 bits on some
+	platforms.
+*/
+
+#include "rng.h"
+
+
+unsigned long long rng_state = 0x9E3779B97F4A7C15ULL;
+unsigned long long rng_arrival_state = 0xD1B54A32D192ED03ULL;
+
+
+/*
+	Scrambles a seed so that nearby seeds give unrelated streams, and a seed of 0
+	still gives a usable (non-zero) state.
+*/
+unsigned long long rngScramble (unsigned long long seed) {
+	unsigned long long z = seed + 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	z = z ^ (z >> 31);
+	return z ? z : 0x9E3779B97F4A7C15ULL;
+}
+
+
+/*
+	Seeds both streams. The arrival stream's seed is kept well apart from the
+	next few seeds the main stream could be given.
+*/
+void rngSeed (unsigned long long seed) {
+	rng_state = rngScramble(seed);
+	rng_arrival_state = rngScramble(seed ^ 0xD1B54A32D192ED03ULL);
+}
+
+
+unsigned long long rngState () {
+	return rng_state;
+}
+
+
+void rngSetState (unsigned long long state) {
+	rng_state = state;
+}
+
+
+unsigned long long rngArrivalState () {
+	return rng_arrival_state;
+}
+
+
+void rngSetArrivalState (unsigned long long state) {
+	rng_arrival_state = state;
+}
+
+
+/*
+	Steps the given stream and returns its next 64 random bits.
+*/
+unsigned long long rngStep (unsigned long long * state) {
+	*state ^= *state >> 12;
+	*state ^= *state << 25;
+	*state ^= *state >> 27;
+	return *state * 0x2545F4914F6CDD1DULL;
+}
+
+
+/*
+	Scales 64 random bits to a number from 0 up to (but not including) the given
+	bound, or 0 if the bound is 0.
+*/
+unsigned int rngScale (unsigned long long bits, unsigned int bound) {
+	return (unsigned int) (((bits >> 32) * bound) >> 32);
+}
+
+
+/*
+	Returns the next 64 random bits.
+*/
+unsigned long long rngNext () {
+	return rngStep(&rng_state);
+}
+
+
+/*
+	Returns a random number from 0 up to (but not including) the given bound, or
+	0 if the bound is 0.
+*/
+unsigned int rngRange (unsigned int bound) {
+	if (bound == 0) {
+		return 0;
+	}
+	return rngScale(rngNext(), bound);
+}
+
+
+/*
+	Returns a random double strictly between 0 and 1, so it is always safe to take
+	the log of.
+*/
+double rngUniform () {
+	return ((rngNext() >> 11) + 0.5) / 9007199254740992.0;
+}
+
+
+/*
+	rngRange, drawn from the arrival stream.
+*/
+unsigned int rngArrivalRange (unsigned int bound) {
+	if (bound == 0) {
+		return 0;
+	}
+	return rngScale(rngStep(&rng_arrival_state), bound);
+}
+
+
+/*
+	rngUniform, drawn from the arrival stream.
+*/
+double rngArrivalUniform () {
+	return ((rngStep(&rng_arrival_state) >> 11) + 0.5) / 9007199254740992.0;
+}
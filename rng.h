@@ -0,0 +1,37 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the declarations of functions for the rng.c file. Every random
+	number in the simulator comes from here, so a run can be repeated from its seed
+	and the generator's state can be saved along with the rest of the simulation.
+	Everything that makes a PCB, its arrival included, draws from the arrival
+	stream and everything else from the main one, so a replayed run makes the
+	same main stream draws as the run it was recorded from.
+*/
+
+#ifndef RNG_H
+#define RNG_H
+
+//declarations
+void rngSeed (unsigned long long);
+
+unsigned long long rngState ();
+
+void rngSetState (unsigned long long);
+
+unsigned long long rngArrivalState ();
+
+void rngSetArrivalState (unsigned long long);
+
+unsigned long long rngNext ();
+
+unsigned int rngRange (unsigned int);
+
+double rngUniform ();
+
+unsigned int rngArrivalRange (unsigned int);
+
+double rngArrivalUniform ();
+
+#endif
@@ -0,0 +1,97 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the defined functions declared in the saturation.h header file.
+	The load is open loop: arrivals come at the offered rate whether or not earlier
+	PCBs have finished, so past the knee the MLFQ simply keeps growing.
+*/
+
+#include "scheduler.h"
+#include <limits.h>
+
+
+/*
+	Runs osLoop once for ticks ticks with the base generator at the given arrival
+	rate, with logging, tracing and the metrics file off, and fills in step with
+	what happened. The configured limits are put back afterwards. Every step uses the same seed, so steps differ only in rate.
+*/
+void runSaturationStep (Generator base, double rate, unsigned int ticks, SaturationStep_s * step) {
+	Generator_s settings = *base;
+	LatencyHist_s turnaround;
+	int savedLog = logEnabled;
+
+	settings.rate = rate;
+	resetSimulation();
+	rngSeed(SATURATION_SEED);
+	generator = &settings;
+	arrivalLimit = INT_MAX;
+	tickLimit = ticks;
+	logEnabled = 0;
+	metricsPath = NULL;
+	osLoop();
+	logEnabled = savedLog;
+	applyConfig();
+
+	histReset(&turnaround);
+	latencyMergeAll(LAT_TURNAROUND, -1, &turnaround);
+	step->offered = rate * 1000.0;
+	step->completed = 1000.0 * turnaround.total / sim_tick;
+	step->utilization = 1.0 - (double) runStats.idle_ticks / sim_tick;
+	step->mean_turnaround = histMean(&turnaround);
+	step->p99_turnaround = histValueAtPercentile(&turnaround, 99.0);
+	step->ready_growth = readyGrowth();
+	step->saturated = step->completed < SATURATION_EFFICIENCY * step->offered
+		|| step->ready_growth > SATURATION_GROWTH;
+}
+
+
+/*
+	Raises the arrival rate by SATURATION_RATE_STEP each step, starting from
+	SATURATION_START_RATE, until SATURATION_CONFIRM steps in a row are saturated.
+	Every step is written to path as a CSV row; the knee column marks the last
+	step before saturation set in, which is also printed. Returns 1 on success,
+	0 if the file could not be written.
+*/
+int runSaturation (const char * path, Generator base) {
+	SaturationStep_s steps[SATURATION_MAX_STEPS];
+	double rate = SATURATION_START_RATE;
+	int count = 0, inARow = 0, knee = -1;
+	FILE * out = fopen(path, "w");
+	if (out == NULL) {
+		fprintf(stderr, "Could not open %s\r\n", path);
+		return 0;
+	}
+
+	while (count < SATURATION_MAX_STEPS && inARow < SATURATION_CONFIRM) {
+		runSaturationStep(base, rate, SATURATION_STEP_TICKS, &steps[count]);
+		printf("offered %8.3f completed %8.3f utilization %5.3f p99 %8u growth %7.3f%s\r\n",
+			steps[count].offered, steps[count].completed, steps[count].utilization,
+			steps[count].p99_turnaround, steps[count].ready_growth,
+			steps[count].saturated ? " saturated" : "");
+		if (steps[count].saturated) {
+			inARow++;
+		} else {
+			inARow = 0;
+			knee = count;
+		}
+		count++;
+		rate *= SATURATION_RATE_STEP;
+	}
+
+	fprintf(out, "step,offered_per_1000,completed_per_1000,utilization,mean_turnaround,p99_turnaround,ready_growth_per_1000,saturated,knee\n");
+	for (int i = 0; i < count; i++) {
+		fprintf(out, "%d,%.4f,%.4f,%.4f,%.1f,%u,%.4f,%d,%d\n", i, steps[i].offered, steps[i].completed,
+			steps[i].utilization, steps[i].mean_turnaround, steps[i].p99_turnaround,
+			steps[i].ready_growth, steps[i].saturated, i == knee);
+	}
+	fclose(out);
+
+	if (knee >= 0) {
+		printf("Saturation point: %.3f arrivals per 1000 ticks (%.1f%% utilization, p99 turnaround %u)\r\n",
+			steps[knee].offered, 100.0 * steps[knee].utilization, steps[knee].p99_turnaround);
+	} else {
+		printf("Saturated at the first step, lower SATURATION_START_RATE\r\n");
+	}
+	return 1;
+}
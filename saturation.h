@@ -0,0 +1,46 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the declarations of functions for the saturation.c file. The
+	saturation benchmark raises the generator's arrival rate step by step until the
+	scheduler can no longer keep up, and writes the throughput and latency of every
+	step as a CSV curve.
+*/
+
+#ifndef SATURATION_H
+#define SATURATION_H
+
+//includes
+#include "workload_gen.h"
+
+
+//defines
+#define SATURATION_SEED 422
+#define SATURATION_START_RATE 0.0002
+#define SATURATION_RATE_STEP 1.25
+#define SATURATION_MAX_STEPS 40
+#define SATURATION_STEP_TICKS 2000000
+#define SATURATION_EFFICIENCY 0.9 // saturated once completions fall below this share of arrivals
+#define SATURATION_GROWTH 0.5 // or the MLFQ grows faster than this many PCBs per 1000 ticks
+#define SATURATION_CONFIRM 2 // saturated steps in a row before the benchmark stops
+
+
+//structs
+typedef struct saturation_step {
+	double offered; // arrivals per 1000 ticks
+	double completed; // terminations per 1000 ticks
+	double utilization;
+	double mean_turnaround;
+	unsigned int p99_turnaround;
+	double ready_growth; // MLFQ growth in PCBs per 1000 ticks
+	int saturated;
+} SaturationStep_s;
+
+
+//declarations
+void runSaturationStep (Generator, double, unsigned int, SaturationStep_s *);
+
+int runSaturation (const char *, Generator);
+
+#endif
@@ -15,6 +15,7 @@
 
 
 unsigned int sysstack;
+PCB sysstackOwner = NULL; // the PCB whose PC is saved in sysstack
 int switchCalls;
 
 Scheduler thisScheduler;
@@ -24,9 +25,23 @@ int privilege_counter = 0;
 int ran_term_num = 0;
 int terminated = 0;
 int currQuantumSize;
-int quantum_tick = 0; // Use for quantum length tracking
+unsigned int sim_tick = 0; // monotonic simulation clock, never reset
+Workload replay = NULL; // arrivals come from here instead of makePCBList when set
+Generator generator = NULL; // or from here, spread across ticks
+WorkloadRecorder recorder = NULL; // every admitted PCB is written here when set
+int liveTerminating = 0; // admitted PCBs with a terminate count that have not terminated yet
+int arrivalLimit = MAX_PCB_TOTAL; // the generator stops after this many PCBs
+unsigned int tickLimit = 0; // the run stops at this tick, 0 to run until the arrivals are done
+const char * metricsPath = METRICS_FILE; // NULL to keep the metrics in memory only
+RunStats_s runStats;
+int logEnabled = 1;
 int io_timer = 0;
+int ioPending = 0; // completions at the front of the Blocked queue waiting for their interrupt
+unsigned int ioPendingSince; // tick the oldest of them completed at
+unsigned long long ioPendingTicks = 0; // sum of the ticks they completed at
 time_t t;
+TimerWheel_s loopTimers; // every timer of osLoop that runs on sim_tick
+TimerNode_s loopTimer[LOOP_TIMER_COUNT];
 
 
 
@@ -38,36 +53,65 @@ time_t t;
 	with the new process.
 */
 void osLoop () {
+	HOT_SCOPE(OS_LOOP);
 	int totalProcesses = 0, iterationCount = 1;
-	thisScheduler = schedulerConstructor();
-	totalProcesses += makePCBList(thisScheduler);
+	// a replay of a run without a generator makes its arrivals where the run did
+	int streamed = (replay != NULL && !(replay->flags & WORKLOAD_AT_RESETS)) || generator != NULL;
+	if (recorder != NULL && !streamed) {
+		recorder->flags |= WORKLOAD_AT_RESETS;
+	}
+	if (restoreFrom != NULL) {
+		thisScheduler = checkpointRestore(restoreFrom, &totalProcesses, &iterationCount);
+		if (thisScheduler == NULL) {
+			fprintf(stderr, "Could not restore the checkpoint\r\n");
+			return;
+		}
+	} else {
+		thisScheduler = schedulerConstructor();
+		if (generator != NULL) {
+			generatorStart(generator, sim_tick);
+		}
+		if (!streamed && replay == NULL) {
+			totalProcesses += makePCBList(thisScheduler);
+		} else {
+			totalProcesses += streamArrivals(thisScheduler, arrivalLimit - totalProcesses);
+		}
+	}
+	armLoopTimers(streamed, totalProcesses);
 	printSchedulerState(thisScheduler);
 	for(;;) {
+		sim_tick++;
+		if (loopTimerDue(TIMER_ARRIVAL)) {
+			totalProcesses += streamArrivals(thisScheduler, arrivalLimit - totalProcesses);
+			armArrivalTimer(streamed, totalProcesses);
+		}
 		if (thisScheduler->running != NULL) { // In case the first makePCBList makes 0 PCBs
 			thisScheduler->running->context->pc++;
+			thisScheduler->running->user_ticks++;
+			flameCount(0, thisScheduler->running->priority, thisScheduler->running->pid, FLAME_USER, 1);
 			
 			if (timerInterrupt(iterationCount) == 1) {
 				pseudoISR(thisScheduler, IS_TIMER);
-				printf("Completed Timer Interrupt\n");
+				LOG("Completed Timer Interrupt\n");
 				printSchedulerState(thisScheduler);
 				iterationCount++;
 			}
 
 			if (ioTrap(thisScheduler->running) == 1) {
-				printf("Iteration: %d\r\n", iterationCount);
-				printf("Initiating I/O Trap\r\n");
-				printf("PC when I/O Trap is Reached: %d\r\n", thisScheduler->running->context->pc);
+				LOG("Iteration: %d\r\n", iterationCount);
+				LOG("Initiating I/O Trap\r\n");
+				LOG("PC when I/O Trap is Reached: %d\r\n", thisScheduler->running->context->pc);
 				pseudoISR(thisScheduler, IS_IO_TRAP);
 				
 				printSchedulerState(thisScheduler);
 				iterationCount++;
-				printf("Completed I/O Trap\n");
+				LOG("Completed I/O Trap\n");
 			}
 			
 			if (thisScheduler->running != NULL)
 			{
 				if (thisScheduler->running->context->pc >= thisScheduler->running->max_pc) {
-					printf("made it here\n");
+					LOG("made it here\n");
 					//exit(0);
 					thisScheduler->running->context->pc = 0;
 					thisScheduler->running->term_count++;	//if terminate value is > 0
@@ -75,62 +119,187 @@ void osLoop () {
 			}
 			
 			if (ioInterrupt(thisScheduler->blocked) == 1) {
-				printf("Iteration: %d\r\n", iterationCount);
-				printf("Initiating I/O Interrupt\n");
+				LOG("Iteration: %d\r\n", iterationCount);
+				LOG("Initiating I/O Interrupt\n");
 				pseudoISR(thisScheduler, IS_IO_INTERRUPT);
 				
 				printSchedulerState(thisScheduler);
 				iterationCount++;
-				printf("Completed I/O Interrupt\n");
+				LOG("Completed I/O Interrupt\n");
 			}
 			
 			// if running PCB's terminate == running PCB's term_count, then terminate (for real).
 			terminate(thisScheduler);
 		} else {
 			iterationCount++;
-			printf("Idle\n");
+			runStats.idle_ticks++;
+			flameCount(0, -1, FLAME_IDLE_PID, FLAME_IDLE, 1);
+			LOG("Idle\n");
+			// I/O still completes while the CPU is idle, and whatever it wakes can run
+			if (ioInterrupt(thisScheduler->blocked) == 1) {
+				LOG("Initiating I/O Interrupt\n");
+				pseudoISR(thisScheduler, IS_IO_INTERRUPT);
+				LOG("Completed I/O Interrupt\n");
+			}
+			if (!pq_is_empty(thisScheduler->ready)) {
+				dispatcher(thisScheduler);
+				printSchedulerState(thisScheduler);
+			}
 		}
 	
 		
-		if (!(iterationCount % RESET_COUNT)) {
-			printf("\r\nRESETTING MLFQ\r\n");
-			printf("iterationCount: %d\n", iterationCount);
-			resetMLFQ(thisScheduler);
-			if (rand() % MAKE_PCB_CHANCE_DOMAIN <= MAKE_PCB_CHANCE_PERCENTAGE) {
+		if (config.aging) {
+			ageMLFQ(thisScheduler);
+		}
+		if (!(iterationCount % config.reset_count)) {
+			if (!config.aging) {
+				LOG("\r\nRESETTING MLFQ\r\n");
+				LOG("iterationCount: %d\n", iterationCount);
+				resetMLFQ(thisScheduler);
+			}
+			if (!streamed && replay != NULL) {
+				totalProcesses += streamArrivals(thisScheduler, arrivalLimit - totalProcesses);
+			} else if (!streamed && rngArrivalRange(MAKE_PCB_CHANCE_DOMAIN) <= MAKE_PCB_CHANCE_PERCENTAGE) {
 				totalProcesses += makePCBList (thisScheduler);
 			}
 			printSchedulerState(thisScheduler);
 			iterationCount = 1;
 		}
-		if (totalProcesses >= MAX_PCB_TOTAL) {
-			printf("Reached max PCBs, ending Scheduler.\r\n");
+		if (thisScheduler->running != NULL) {
+			traceRunning(sim_tick, 0, thisScheduler->running->pid, thisScheduler->running->priority);
+		} else {
+			traceRunning(sim_tick, 0, TRACE_IDLE_PID, 0);
+		}
+		if (loopTimerDue(TIMER_METRICS)) {
+			exportMetrics(thisScheduler);
+			sampleReadyLength(thisScheduler);
+			twAdd(&loopTimers, &loopTimer[TIMER_METRICS], sim_tick + config.metrics_interval);
+		}
+		if (loopTimerDue(TIMER_FORK)) {
+			whatIfFork(thisScheduler);
+		}
+		if (loopTimerDue(TIMER_CHECKPOINT) && checkpointPath != NULL) { // a what-if branch leaves it to the baseline
+			if (checkpointSave(checkpointPath, thisScheduler, totalProcesses, iterationCount)) {
+				fprintf(stderr, "Checkpoint written to %s at tick %u\r\n", checkpointPath, sim_tick);
+			} else {
+				fprintf(stderr, "Could not write the checkpoint %s\r\n", checkpointPath);
+			}
+		}
+		if (loopTimerDue(TIMER_LIMIT)) {
+			LOG("Reached the tick limit, ending Scheduler.\r\n");
+			if (recorder != NULL) {
+				recorder->flags |= WORKLOAD_CUT_SHORT;
+			}
+			break;
+		}
+		if (!streamed && madeEnough(totalProcesses)) {
+			LOG("Reached max PCBs, ending Scheduler.\r\n");
+			break;
+		}
+		// PCBs with a terminate count of 0 never end, so only wait on the others
+		if (streamed && streamDone(totalProcesses) && liveTerminating == 0 && !replayRunsOn()) {
+			LOG("Every arrival has terminated, ending Scheduler.\r\n");
 			break;
 		}
+		skipIdleTicks(thisScheduler, &iterationCount, streamed);
+	}
+	exportMetrics(thisScheduler);
+	traceClose(sim_tick);
+	if (logEnabled) {
+		latencyReport(stdout);
+		ioCoalesceReport(stdout);
+		if (config.adaptive_quantum) {
+			adaptReport(thisScheduler->ready, stdout);
+		}
+	}
+	schedulerDeconstructor(thisScheduler);
+	thisScheduler = NULL;
+}
+
+
+/*
+	Puts every global the loop uses back to how it starts, so that osLoop can be
+	run more than once in the same process.
+*/
+void resetSimulation () {
+	sim_tick = 0;
+	io_timer = 0;
+	ioPending = 0;
+	ioPendingTicks = 0;
+	sysstack = 0;
+	sysstackOwner = NULL;
+	switchCalls = 0;
+	currQuantumSize = 0;
+	liveTerminating = 0;
+	memset(privileged, 0, sizeof(privileged));
+	memset(&runStats, 0, sizeof(runStats));
+	latencyReset();
+	adaptReset();
+}
+
+
+/*
+	Adds the current MLFQ length to the least squares fit of length against time,
+	which readyGrowth turns into the rate the MLFQ is growing at.
+*/
+void sampleReadyLength (Scheduler theScheduler) {
+	double length = 0;
+	for (int i = 0; i < theScheduler->ready->levels; i++) {
+		length += theScheduler->ready->queues[i]->size;
+	}
+	runStats.samples++;
+	runStats.sum_t += sim_tick;
+	runStats.sum_len += length;
+	runStats.sum_tt += (double) sim_tick * sim_tick;
+	runStats.sum_tlen += sim_tick * length;
+}
+
+
+/*
+	Returns how many PCBs per 1000 ticks the MLFQ grew by over the run, the slope
+	of the least squares fit of the sampled lengths.
+*/
+double readyGrowth () {
+	double n = runStats.samples;
+	double denominator = n * runStats.sum_tt - runStats.sum_t * runStats.sum_t;
+	if (n < 2 || denominator == 0) {
+		return 0.0;
 	}
+	return 1000.0 * (n * runStats.sum_tlen - runStats.sum_t * runStats.sum_len) / denominator;
 }
 
 
 /*
-	Checks if the global quantum tick is greater than or equal to
-	the current quantum size for the running PCB. If so, then reset
-	the quantum tick to 0 and return 1 so the pseudoISR can occur.
-	If not, increase quantum tick by 1.
+	Checks if the running PCB has used up its quantum, by comparing the ticks it
+	has run against the deadline startQuantum gave it. If so, return 1 so the
+	pseudoISR can occur; the PCB is left with 0 quantum remaining so it gets a
+	fresh one on its next dispatch. Nothing is written while the quantum lasts.
 */
 int timerInterrupt(int iterationCount)
 {
-	if (quantum_tick >= currQuantumSize)
+	HOT_SCOPE(TIMER_INTERRUPT);
+	PCB current = thisScheduler->running;
+	if (current->user_ticks >= current->quantum_end)
 	{
-		printf("Iteration: %d\r\n", iterationCount);
-		printf("Initiating Timer Interrupt\n");
-		printf("Current quantum tick: %d\r\n", quantum_tick);
-		quantum_tick = 0;
+		LOG("Iteration: %d\r\n", iterationCount);
+		LOG("Initiating Timer Interrupt\n");
+		LOG("Quantum used: %d\r\n", currQuantumSize);
 		return 1;
 	}
-	else
-	{
-		quantum_tick++;
-		return 0;
-	}
+	return 0;
+}
+
+
+/*
+	Starts the time slice of a PCB being dispatched, which lasts the given
+	ticks after the tick it is first run in. The deadline is kept in the PCB's
+	own user_ticks, which only move while it runs, so ISR ticks spent waking
+	other PCBs do not come out of its slice.
+*/
+void startQuantum (PCB pcb, unsigned int slice) {
+	pcb->burst_start = pcb->user_ticks;
+	pcb->quantum_end = pcb->user_ticks + 1 + slice;
+	pcb->quantum_remaining = 0;
 }
 
 
@@ -140,6 +309,7 @@ int timerInterrupt(int iterationCount)
 */
 int ioTrap(PCB current)
 {
+	HOT_SCOPE(IO_TRAP);
 	unsigned int the_pc = current->context->pc;
 	int c;
 	for (c = 0; c < TRAP_COUNT; c++)
@@ -162,18 +332,27 @@ int ioTrap(PCB current)
 
 
 /*
-	Checks if the next up PCB in the Blocked queue has reached its max 
-	blocked_timer value yet. If so, return 1 and initiate the IO Interrupt.
+	Checks if the PCB the device is serving, the first in the Blocked queue behind
+	those already done, has reached its max blocked_timer value yet. If so, its
+	I/O is done and it waits at the front for the IO Interrupt. Returns 1 once
+	io_coalesce_count completions are waiting, once the oldest has waited
+	io_coalesce_ticks (if set), or once the device has nothing left to serve, so
+	that one ISR wakes them all. The defaults interrupt on every completion.
 */
 int ioInterrupt(ReadyQueue the_blocked)
 {
-	if (the_blocked->first_node != NULL && q_peek(the_blocked) != NULL)
+	HOT_SCOPE(IO_INTERRUPT);
+	PCB nextup = q_peek_at(the_blocked, ioPending);
+	if (nextup != NULL)
 	{
-		PCB nextup = q_peek(the_blocked);
 		if (io_timer >= nextup->blocked_timer)
 		{
 			io_timer = 0;
-			return 1;
+			if (ioPending++ == 0)
+			{
+				ioPendingSince = sim_tick;
+			}
+			ioPendingTicks += sim_tick;
 		}
 		else
 		{
@@ -181,48 +360,297 @@ int ioInterrupt(ReadyQueue the_blocked)
 		}
 	}
 	
+	if (ioPending > 0 && (ioPending >= config.io_coalesce_count
+			|| (config.io_coalesce_ticks > 0 && sim_tick - ioPendingSince >= config.io_coalesce_ticks)
+			|| q_peek_at(the_blocked, ioPending) == NULL))
+	{
+		runStats.io_interrupts++;
+		runStats.io_completions += ioPending;
+		runStats.io_delay_ticks += (unsigned long long) ioPending * sim_tick - ioPendingTicks;
+		metricsAdd(MET_IO_COALESCE_DELAY, (unsigned long long) ioPending * sim_tick - ioPendingTicks);
+		return 1;
+	}
 	return 0;
 }
 
 
+/*
+	Prints how much coalescing I/O completions saved against what it cost. Every
+	ISR takes one tick, so each completion that shared an interrupt saved one
+	tick of system time, paid for by the ticks completed I/O waited to be woken.
+*/
+void ioCoalesceReport (FILE * out) {
+	unsigned long long saved = runStats.io_completions - runStats.io_interrupts;
+	fprintf(out, "I/O completions: %llu in %llu interrupts, %llu ISR ticks saved, "
+		"%.2f ticks added to each wake-up\r\n", runStats.io_completions, runStats.io_interrupts, saved,
+		runStats.io_completions ? (double) runStats.io_delay_ticks / runStats.io_completions : 0.0);
+}
+
+
 /*
 	This creates the list of new PCBs for the current loop through. It simulates
 	the creation of each PCB, the changing of state to new, enqueueing into the
 	list of created PCBs, and moving each of those PCBs into the ready queue.
 */
 int makePCBList (Scheduler theScheduler) {
-	int newPCBCount = rand() % MAX_PCB_IN_ROUND;
+	PCB newPCBs[MAX_PCB_IN_ROUND];
+	int newPCBCount = rngArrivalRange(MAX_PCB_IN_ROUND);
 	//int newPCBCount = 3;
 	
-	int lottery = rand();
 	for (int i = 0; i < newPCBCount; i++) {
-		PCB newPCB = PCB_create();
-		newPCB->state = STATE_NEW;
+		newPCBs[i] = PCB_create();
+		PCB_transition(newPCBs[i], STATE_NEW, sim_tick);
+		newPCBs[i]->creation = sim_tick;
+	}
+	q_enqueue_batch(theScheduler->created, newPCBs, newPCBCount);
+	LOG("Making New PCBs: \r\n");
+	admitCreated(theScheduler);
+	
+	return newPCBCount;
+}
+
+
+/*
+	Creates a PCB for every arrival from the replayed workload or the generator
+	that is due by now, and admits them the same way makePCBList does. The
+	generator stops after limit PCBs; a replay always runs to the end of its file.
+	A replay of a run without a generator is called at each MLFQ reset, where the
+	run called makePCBList, instead of on the arrival timer.
+*/
+int streamArrivals (Scheduler theScheduler, int limit) {
+	HOT_SCOPE(STREAM_ARRIVALS);
+	int newPCBCount = 0;
+	PCB newPCB;
+	for (;;) {
+		if (replay != NULL) {
+			newPCB = workloadNext(replay, sim_tick);
+		} else if (newPCBCount < limit) {
+			newPCB = generatorNext(generator, sim_tick);
+		} else {
+			newPCB = NULL;
+		}
+		if (newPCB == NULL) {
+			break;
+		}
+		PCB_transition(newPCB, STATE_NEW, sim_tick);
+		newPCB->creation = sim_tick;
 		q_enqueue(theScheduler->created, newPCB);
+		newPCBCount++;
 	}
-	printf("Making New PCBs: \r\n");
 	if (newPCBCount) {
-		while (!q_is_empty(theScheduler->created)) {
-			PCB nextPCB = q_dequeue(theScheduler->created);
-			nextPCB->state = STATE_READY;
-			toStringPCB(nextPCB, 0);
-			printf("\r\n");
-			pq_enqueue(theScheduler->ready, nextPCB);
+		LOG("Arriving New PCBs: \r\n");
+		admitCreated(theScheduler);
+	}
+	
+	return newPCBCount;
+}
+
+
+/*
+	Returns 1 once the replay or generator has no more arrivals to make.
+*/
+int streamDone (int totalProcesses) {
+	if (replay != NULL) {
+		return workloadDone(replay);
+	}
+	return totalProcesses >= arrivalLimit;
+}
+
+
+/*
+	Returns 1 once a run that makes its PCBs at MLFQ resets has made as many as
+	it may. A replay of one has when it has made the last of them.
+*/
+int madeEnough (int totalProcesses) {
+	if (replay != NULL) {
+		return workloadDone(replay) && !replayRunsOn();
+	}
+	return totalProcesses >= arrivalLimit;
+}
+
+
+/*
+	Returns 1 if the replayed run was stopped at its tick limit before its
+	arrivals ran out, so this one runs to its own tick limit too instead of
+	ending with them.
+*/
+int replayRunsOn () {
+	return replay != NULL && (replay->flags & WORKLOAD_CUT_SHORT) && tickLimit;
+}
+
+
+/*
+	Starts the loop's timer wheel at this tick, with every timer the settings
+	ask for. A fork or checkpoint tick that has already gone by is never reached.
+*/
+void armLoopTimers (int streamed, int totalProcesses) {
+	twInit(&loopTimers, sim_tick);
+	memset(loopTimer, 0, sizeof(loopTimer));
+	armArrivalTimer(streamed, totalProcesses);
+	twAdd(&loopTimers, &loopTimer[TIMER_METRICS], sim_tick + config.metrics_interval);
+	if (whatIf.count > 0 && whatIf.branch < 0 && whatIf.at > sim_tick) {
+		twAdd(&loopTimers, &loopTimer[TIMER_FORK], whatIf.at);
+	}
+	if (checkpointPath != NULL && checkpointTick > sim_tick) {
+		twAdd(&loopTimers, &loopTimer[TIMER_CHECKPOINT], checkpointTick);
+	}
+	if (tickLimit) {
+		twAdd(&loopTimers, &loopTimer[TIMER_LIMIT], tickLimit);
+	}
+}
+
+
+/*
+	Sets the arrival timer to the tick of the next streamed arrival, if there
+	is one to come.
+*/
+void armArrivalTimer (int streamed, int totalProcesses) {
+	unsigned int next;
+	if (!streamed || streamDone(totalProcesses)) {
+		return;
+	}
+	next = replay != NULL ? workloadNextArrival(replay) : generatorNextArrival(generator);
+	if (next != (unsigned int) -1) {
+		twAdd(&loopTimers, &loopTimer[TIMER_ARRIVAL], next);
+	}
+}
+
+
+/*
+	Brings the loop's timers up to this tick, and returns 1 if the given one has
+	gone off since it was last asked about. The wheel is only touched when
+	something in it is due, so this is a compare on most ticks.
+*/
+int loopTimerDue (enum loop_timer timer) {
+	if (sim_tick >= loopTimers.next) {
+		twAdvance(&loopTimers, sim_tick, NULL, NULL);
+	}
+	if (loopTimer[timer].fired) {
+		loopTimer[timer].fired = 0;
+		return 1;
+	}
+	return 0;
+}
+
+
+/*
+	Lowers ahead so that skipped ticks stop short of the given tick, unless that
+	tick has already gone by.
+*/
+void stopBefore (unsigned long long * ahead, unsigned long long tick) {
+	if (tick > sim_tick && tick - sim_tick - 1 < *ahead) {
+		*ahead = tick - sim_tick - 1;
+	}
+}
+
+
+/*
+	Called at the end of a tick. If the CPU is idle with nothing ready, jumps
+	over the ticks after this one in which nothing would happen: no I/O
+	completion or coalesced interrupt, and no timer in the loop's wheel, which
+	has the arrivals and the ticks osLoop stops at to export metrics, fork,
+	checkpoint or end. The skipped ticks count as idle time and as time the
+	device spent serving I/O, exactly as if they had been run one at a time, so
+	sparse workloads cost per event instead of per tick.
+
+	An MLFQ reset of an empty MLFQ only counts a boost and marks the Scheduler
+	new, so with streamed arrivals the resets along the way are counted instead
+	of run, and iterationCount is left where they would have left it. Without
+	them, a reset may make PCBs, so the skip stops short of the next one; the
+	same goes for a traced run, which shows every reset. With aging on, the
+	resets boost nothing, so there is nothing to count.
+*/
+void skipIdleTicks (Scheduler theScheduler, int * iterationCount, int streamed) {
+	unsigned long long ahead = (unsigned int) -1 - sim_tick, resets = 0;
+	unsigned long long first = config.reset_count - *iterationCount % config.reset_count; // ticks to the next reset
+	unsigned long long period = config.reset_count > 1 ? config.reset_count - 1 : 1; // and between the ones after it
+	PCB serving;
+	// an arrival an ISR tick went past is taken at the top of the next tick
+	if (!config.tickless_idle || theScheduler->running != NULL || !pq_is_empty(theScheduler->ready)
+			|| loopTimer[TIMER_ARRIVAL].fired) {
+		return;
+	}
+	serving = q_peek_at(theScheduler->blocked, ioPending);
+	if (serving != NULL) {
+		stopBefore(&ahead, sim_tick + 1ULL + (serving->blocked_timer > (unsigned int) io_timer
+			? serving->blocked_timer - io_timer : 0));
+	} else if (ioPending > 0) {
+		return;
+	}
+	if (ioPending > 0 && config.io_coalesce_ticks > 0) {
+		stopBefore(&ahead, (unsigned long long) ioPendingSince + config.io_coalesce_ticks);
+	}
+	if (!streamed || traceEnabled()) {
+		stopBefore(&ahead, sim_tick + first);
+	}
+	stopBefore(&ahead, twNextDeadline(&loopTimers));
+	if (ahead == 0) {
+		return;
+	}
+
+	if (ahead >= first) {
+		resets = 1 + (ahead - first) / period;
+		*iterationCount = 1 + (ahead - first) % period;
+		if (!config.aging) {
+			metricsAdd(MET_MLFQ_BOOSTS, resets);
+			theScheduler->isNew = 1;
 		}
-		printf("\r\n");
+	} else {
+		*iterationCount += ahead;
+	}
+	LOG("Idle for %llu ticks, through %llu MLFQ resets\n", ahead, resets);
+	sim_tick += ahead;
+	runStats.idle_ticks += ahead;
+	if (serving != NULL) {
+		io_timer += ahead;
+	}
+	flameCount(0, -1, FLAME_IDLE_PID, FLAME_IDLE, ahead);
+}
+
+
+/*
+	Moves every PCB in the created queue into the MLFQ, PCB_BATCH at a time,
+	recording each one if a recorder is open. If nothing is running yet, the
+	highest priority PCB is dispatched straight away.
+*/
+void admitCreated (Scheduler theScheduler) {
+	PCB batch[PCB_BATCH];
+	unsigned int count;
+	if (!q_is_empty(theScheduler->created)) {
+		while ((count = q_dequeue_n(theScheduler->created, batch, PCB_BATCH)) > 0) {
+			for (unsigned int i = 0; i < count; i++) {
+				PCB nextPCB = batch[i];
+				PCB_transition(nextPCB, STATE_READY, sim_tick);
+				if (nextPCB->priority >= theScheduler->ready->levels) {
+					nextPCB->priority = theScheduler->ready->levels - 1;
+				}
+				toStringPCB(nextPCB, 0);
+				LOG("\r\n");
+				if (recorder != NULL) {
+					recorderWrite(recorder, nextPCB, sim_tick);
+				}
+				if (nextPCB->terminate > 0) {
+					liveTerminating++;
+				}
+			}
+			pq_enqueue_batch(theScheduler->ready, batch, count);
+		}
+		LOG("\r\n");
 
-		if (theScheduler->isNew) {
-			printf("Dequeueing PCB ");
+		if (theScheduler->isNew && theScheduler->running == NULL) {
+			LOG("Dequeueing PCB ");
 			toStringPCB(pq_peek(theScheduler->ready), 0);
-			printf("\r\n\r\n");
+			LOG("\r\n\r\n");
+			currQuantumSize = getNextQuantumSize(theScheduler->ready);
 			theScheduler->running = pq_dequeue(theScheduler->ready);
-			theScheduler->running->state = STATE_RUNNING;
+			PCB_transition(theScheduler->running, STATE_RUNNING, sim_tick);
+			startQuantum(theScheduler->running, currQuantumSize);
 			theScheduler->isNew = 0;
-			currQuantumSize = theScheduler->ready->queues[0]->quantum_size;
+			switchCalls++;
+			metricsInc(MET_CONTEXT_SWITCHES);
 		}
 	}
-	
-	return newPCBCount;
+	traceSchedulerQueues(theScheduler);
 }
 
 
@@ -235,7 +663,7 @@ unsigned int runProcess (unsigned int pc, int quantumSize) {
 	//priority levels.
 	unsigned int jump;
 	if (quantumSize != 0) {
-		jump = rand() % quantumSize;
+		jump = rngRange(quantumSize);
 	}
 	
 	pc += jump;
@@ -246,14 +674,26 @@ unsigned int runProcess (unsigned int pc, int quantumSize) {
 /*
 	Marks the running PCB as terminated. This means it will increment its term_count, if the
 	term_count is then over its maximum terminate amount, then it will be enqueued into the
-	Killed queue which will empty when it reaches its TOTAL_TERMINATED size.
+	Killed queue which will empty when it reaches its total_terminated size.
 */
 void terminate(Scheduler theScheduler) {
+	HOT_SCOPE(TERMINATE);
 	if(theScheduler->running != NULL && theScheduler->running->terminate > 0 && theScheduler->running->terminate == theScheduler->running->term_count)
 	{
-		printf("Marking for termination...\r\n");
-		theScheduler->running->state = STATE_HALT;
-		printf("...\r\n");
+		PCB current = theScheduler->running;
+		LOG("Marking for termination...\r\n");
+		PCB_transition(current, STATE_HALT, sim_tick);
+		current->termination = sim_tick;
+		if (config.adaptive_quantum) {
+			adaptBurst(theScheduler->ready, current, 0);
+		}
+		LOG("PID %d: creation %d, termination %d, user %d, system %d, ready %d, blocked %d\r\n",
+			current->pid, current->creation, current->termination, current->user_ticks,
+			current->system_ticks, current->ready_ticks, current->blocked_ticks);
+		latencyRecordTermination(current);
+		liveTerminating--;
+		metricsInc(MET_TERMINATIONS);
+		LOG("...\r\n");
 		scheduling(IS_TERMINATING, theScheduler);	
 	}
 	
@@ -264,15 +704,28 @@ void terminate(Scheduler theScheduler) {
 	This acts as an Interrupt Service Routine, but only for the Timer interrupt.
 	It handles changing the running PCB state to Interrupted, moving the running
 	PCB to interrupted, saving the PC to the SysStack and calling the scheduler.
+	The ISR takes one tick, which is charged to the running PCB as system time,
+	and to the flame graph as a context switch if another PCB runs after it.
 */
 void pseudoISR (Scheduler theScheduler, int interruptType) {
+	HOT_SCOPE(PSEUDO_ISR);
+	PCB running = theScheduler->running;
+	int level = running != NULL ? running->priority : -1;
+	int pid = running != NULL ? running->pid : FLAME_IDLE_PID;
+	sim_tick++;
 	if (theScheduler->running && theScheduler->running->state != STATE_HALT) {
-		theScheduler->running->state = STATE_INT;
+		sysstack = theScheduler->running->context->pc;
+		sysstackOwner = theScheduler->running;
+		theScheduler->running->system_ticks++;
+		PCB_transition(theScheduler->running, STATE_INT, sim_tick);
 		theScheduler->interrupted = theScheduler->running;
 	}
 	scheduling(interruptType, theScheduler);
 	pseudoIRET(theScheduler);
-	printf("Exiting ISR\n");
+	running = theScheduler->running;
+	flameCount(0, level, pid, (running != NULL ? running->pid : FLAME_IDLE_PID) != pid ? FLAME_SWITCH : FLAME_ISR, 1);
+	traceSchedulerQueues(theScheduler);
+	LOG("Exiting ISR\n");
 }
 
 
@@ -282,90 +735,114 @@ void pseudoISR (Scheduler theScheduler, int interruptType) {
 	the current list of "privileged PCBs" that will not be terminated.
 */
 void printSchedulerState (Scheduler theScheduler) {
-	printf("MLFQ State\r\n");
+	LOG("MLFQ State\r\n");
 	toStringPriorityQueue(theScheduler->ready);
-	printf("\r\n");
+	LOG("\r\n");
 	
 	int index = 0;
 	// PRIVILIGED PID
 	while(privileged[index] != NULL && index < MAX_PRIVILEGE) {
-		printf("PCB PID %d, PRIORITY %d, PC %d\n", 
+		LOG("PCB PID %d, PRIORITY %d, PC %d\n", 
 		privileged[index]->pid, privileged[index]->priority, 
 		privileged[index]->context->pc);
 		index++;
 	}
-	printf("blocked size: %d\r\n", theScheduler->blocked->size);
-	printf("killed size: %d\r\n", theScheduler->killed->size);
-	printf("\r\n");
+	LOG("blocked size: %d\r\n", theScheduler->blocked->size);
+	LOG("killed size: %d\r\n", theScheduler->killed->size);
+	LOG("\r\n");
 	
 	if (pq_peek(theScheduler->ready) != NULL) {
-		printf("Going to be running ");
+		LOG("Going to be running ");
 		if (theScheduler->running) {
 			toStringPCB(theScheduler->running, 0);
 		} else {
-			printf("\r\n");
+			LOG("\r\n");
 		}
-		printf("Next highest priority PCB ");
+		LOG("Next highest priority PCB ");
 		toStringPCB(pq_peek(theScheduler->ready), 0);
-		printf("\r\n\r\n\r\n");
+		LOG("\r\n\r\n\r\n");
 	} else {
 		
 		if (theScheduler->running != NULL) {
-			printf("Going to be running ");
+			LOG("Going to be running ");
 			toStringPCB(theScheduler->running, 0);
 		} else {
-			printf("\r\n");
+			LOG("\r\n");
 		}
 
-		printf("Next highest priority PCB contents: The MLFQ is empty!\r\n");
-		printf("\r\n\r\n\r\n");
+		LOG("Next highest priority PCB contents: The MLFQ is empty!\r\n");
+		LOG("\r\n\r\n\r\n");
 	}
 }
 
 
 /*
 	Used to move every value in the MLFQ back to the highest priority
-	ReadyQueue after a predetermined time. It does this by taking the first value
-	of each ReadyQueue (after the 0 *highest priority* queue) and setting it to
-	be the new last value of the 0 queue.
+	ReadyQueue after a predetermined time. It does this by splicing each
+	ReadyQueue (after the 0 *highest priority* queue) onto the end of the 0
+	queue.
 */
 void resetMLFQ (Scheduler theScheduler) {
+	HOT_SCOPE(RESET_MLFQ);
 	int allEmpty = 1;
-	for (int i = 1; i < NUM_PRIORITIES; i++) {
+	metricsInc(MET_MLFQ_BOOSTS);
+	for (int i = 1; i < theScheduler->ready->levels; i++) {
 		ReadyQueue curr = theScheduler->ready->queues[i];
 		if (!q_is_empty(curr)) {
 			if (!q_is_empty(theScheduler->ready->queues[0])) {
-				theScheduler->ready->queues[0]->last_node->next = curr->first_node;
-				theScheduler->ready->queues[0]->last_node = curr->last_node;
-				theScheduler->ready->queues[0]->size += curr->size;
 				allEmpty = 0;
-			} else {
-				theScheduler->ready->queues[0]->first_node = curr->first_node;
-				theScheduler->ready->queues[0]->last_node = curr->last_node;
-				theScheduler->ready->queues[0]->size = curr->size;
 			}
 			resetReadyQueue(curr);
+			q_splice(theScheduler->ready->queues[0], curr);
 		}
 	}
 	
 	if (allEmpty) {
 		theScheduler->isNew = 1;
 	}
+	traceGlobalInstant(sim_tick, "resetMLFQ");
+	traceSchedulerQueues(theScheduler);
 }
 
 
 /*
-	Resets the given ReadyQueue to be empty.
+	Moves every PCB that has waited at its level for its level's age up one
+	level, to the back of the level above, with a fresh quantum and its wait
+	there starting over. Every PCB joins the back of a level, so each level is
+	in the order its PCBs joined it and only the front of each needs looking at.
 */
-void resetReadyQueue (ReadyQueue queue) {
-	ReadyQueueNode ptr = queue->first_node;
-	while (ptr) {
-		ptr->pcb->priority = 0;
-		ptr = ptr->next;
+void ageMLFQ (Scheduler theScheduler) {
+	HOT_SCOPE(AGE_MLFQ);
+	PriorityQueue ready = theScheduler->ready;
+	for (int i = 1; i < ready->levels; i++) {
+		PCB oldest;
+		while ((oldest = q_peek(ready->queues[i])) != NULL && sim_tick - oldest->level_since >= config.age[i]) {
+			q_dequeue(ready->queues[i]);
+			oldest->priority = i - 1;
+			oldest->quantum_remaining = 0;
+			oldest->level_since = sim_tick;
+			q_enqueue(ready->queues[i - 1], oldest);
+			metricsInc(MET_AGING_PROMOTIONS);
+		}
 	}
-	queue->first_node = NULL;
-	queue->last_node = NULL;
-	queue->size = 0;
+}
+
+
+/*
+	Boosts one PCB to priority 0 with a fresh quantum.
+*/
+void boostPCB (PCB pcb, void * arg) {
+	pcb->priority = 0;
+	pcb->quantum_remaining = 0;
+}
+
+
+/*
+	Boosts every PCB in the given ReadyQueue to priority 0 with a fresh quantum,
+	ready to be spliced onto the 0 queue.
+*/
+void resetReadyQueue (ReadyQueue queue) {
+	q_visit(queue, boostPCB, NULL);
 }
 
 
@@ -377,19 +854,21 @@ void resetReadyQueue (ReadyQueue queue) {
 	back into the MLFQ. If it is a termination, then the running PCB will be marked 
 	as such and, if its term_count is greater than its maximum terminate amount, will 
 	be enqueued into the Killed queue. Then, if the Killed queue is at or above its own 
-	TOTAL_TERMINATED size, it will be emptied. It then calls the dispatcher to get the 
+	total_terminated size, it will be emptied. It then calls the dispatcher to get the 
 	next PCB in the queue.
 */
 void scheduling (int interrupt_code, Scheduler theScheduler) {
+	HOT_SCOPE(SCHEDULING);
 	if (interrupt_code == IS_TIMER) {
-		printf("Entering Timer Interrupt\r\n");
-		theScheduler->interrupted->state = STATE_READY;
-		if (theScheduler->interrupted->priority < (NUM_PRIORITIES - 1)) {
-			theScheduler->interrupted->priority++;
-		} else {
-			theScheduler->interrupted->priority = 0;
+		LOG("Entering Timer Interrupt\r\n");
+		metricsInc(MET_TIMER_INTERRUPTS);
+		PCB_transition(theScheduler->interrupted, STATE_READY, sim_tick);
+		if (config.adaptive_quantum) {
+			adaptBurst(theScheduler->ready, theScheduler->interrupted, 1);
 		}
-		printf("\r\nEnqueueing into MLFQ\r\n");
+		theScheduler->interrupted->priority = config.demote[theScheduler->interrupted->priority];
+		traceInstant(sim_tick, 0, "demote", theScheduler->interrupted->pid, theScheduler->interrupted->priority);
+		LOG("\r\nEnqueueing into MLFQ\r\n");
 		toStringPCB(theScheduler->running, 0);
 		pq_enqueue(theScheduler->ready, theScheduler->interrupted);
 		
@@ -398,45 +877,62 @@ void scheduling (int interrupt_code, Scheduler theScheduler) {
 		if (index != 0) {
 			privileged[index] = theScheduler->running;
 		}
-		printf("Exiting Timer Interrupt\r\n");
+		LOG("Exiting Timer Interrupt\r\n");
 	}
 	else if (interrupt_code == IS_IO_TRAP)
 	{
 		// Do I/O trap handling
-		printf("Entering IO Trap\r\n");
-		int timer = (rand() % TIMER_RANGE + 1);
+		LOG("Entering IO Trap\r\n");
+		metricsInc(MET_IO_TRAPS);
+		int timer = (rngRange(config.timer_range) + 1);
 		theScheduler->interrupted->blocked_timer = timer;
-		theScheduler->interrupted->state = STATE_WAIT;
-		printf("\r\nEnqueueing into Blocked queue\r\n");
+		theScheduler->interrupted->io_count++;
+		traceInstant(sim_tick, 0, "block", theScheduler->interrupted->pid, theScheduler->interrupted->priority);
+		PCB_transition(theScheduler->interrupted, STATE_WAIT, sim_tick);
+		if (config.adaptive_quantum) {
+			adaptBurst(theScheduler->ready, theScheduler->interrupted, 0);
+		}
+		// what is left after this tick, which the PCB has already run
+		theScheduler->interrupted->quantum_remaining = config.quantum_carry_over
+			? theScheduler->interrupted->quantum_end - theScheduler->interrupted->user_ticks - 1 : 0;
+		LOG("\r\nEnqueueing into Blocked queue\r\n");
 		toStringPCB(theScheduler->interrupted, 0);
 		//exit(0);
 		q_enqueue(theScheduler->blocked, theScheduler->interrupted);
 		theScheduler->interrupted = NULL;
 		
 		// schedule a new process
-		printf("Exiting IO Trap\r\n");
+		LOG("Exiting IO Trap\r\n");
 	}
 	else if (interrupt_code == IS_IO_INTERRUPT)
 	{
-		printf("Entering IO Interrupt\r\n");
-		// Do I/O interrupt handling
-		printf("\r\nEnqueueing into MLFQ from Blocked queue\r\n");
-		toStringPCB(q_peek(theScheduler->blocked), 0);
-		pq_enqueue(theScheduler->ready, q_dequeue(theScheduler->blocked));
-		printSchedulerState(theScheduler);
+		LOG("Entering IO Interrupt\r\n");
+		metricsInc(MET_IO_INTERRUPTS);
+		// Do I/O interrupt handling, waking every PCB whose I/O is done
+		for (; ioPending > 0; ioPending--)
+		{
+			LOG("\r\nEnqueueing into MLFQ from Blocked queue\r\n");
+			toStringPCB(q_peek(theScheduler->blocked), 0);
+			PCB woken = q_dequeue(theScheduler->blocked);
+			PCB_transition(woken, STATE_READY, sim_tick);
+			woken->priority = config.promote[woken->priority];
+			pq_enqueue(theScheduler->ready, woken);
+			metricsInc(MET_IO_COMPLETIONS);
+		}
+		ioPendingTicks = 0;
 		if (theScheduler->interrupted != NULL)
 		{
 			theScheduler->running = theScheduler->interrupted;
-			theScheduler->running->state = STATE_RUNNING;
+			PCB_transition(theScheduler->running, STATE_RUNNING, sim_tick);
 		
 			sysstack = theScheduler->running->context->pc;
 		}
 		theScheduler->interrupted = NULL;
-		printf("Exiting IO Interrupt\r\n");
+		LOG("Exiting IO Interrupt\r\n");
 	}
 	
 	if (theScheduler->running != NULL && theScheduler->running->state == STATE_HALT) {
-		printf("\r\nEnqueueing into Killed queue\r\n");
+		LOG("\r\nEnqueueing into Killed queue\r\n");
 		q_enqueue(theScheduler->killed, theScheduler->running);
 		theScheduler->running = NULL;
 	}
@@ -448,7 +944,7 @@ void scheduling (int interrupt_code, Scheduler theScheduler) {
 		theScheduler->running = pq_peek(theScheduler->ready);
 	}
 	
-	if (theScheduler->killed->size >= TOTAL_TERMINATED) {
+	if (theScheduler->killed->size >= config.total_terminated) {
 		PCB toKill;
 		if (!q_is_empty(theScheduler->killed)) {
 			toKill = q_dequeue(theScheduler->killed);
@@ -476,60 +972,137 @@ void scheduling (int interrupt_code, Scheduler theScheduler) {
 
 /*
 	This simply gets the next ready PCB from the Ready queue and moves it into the
-	running state of the Scheduler.
+	running state of the Scheduler. A PCB that blocked partway through its quantum
+	resumes with what it had left (if quantum_carry_over is set), otherwise it gets
+	the full quantum of its level.
 */
 void dispatcher (Scheduler theScheduler) {
+	HOT_SCOPE(DISPATCHER);
 	if (pq_peek(theScheduler->ready) != NULL && pq_peek(theScheduler->ready)->state != STATE_HALT) {
 		currQuantumSize = getNextQuantumSize(theScheduler->ready);
 		theScheduler->running = pq_dequeue(theScheduler->ready);
-		theScheduler->running->state = STATE_RUNNING;
+		PCB_transition(theScheduler->running, STATE_RUNNING, sim_tick);
+		startQuantum(theScheduler->running, theScheduler->running->quantum_remaining > 0
+			? theScheduler->running->quantum_remaining : currQuantumSize);
 		theScheduler->interrupted = NULL;
+		switchCalls++;
+		metricsInc(MET_CONTEXT_SWITCHES);
 	}
 }
 
 
 /*
-	This simply sets the running PCB's PC to the value in the SysStack;
+	This simply sets the running PCB's PC to the value in the SysStack, if the
+	running PCB is the one the ISR saved it from. A newly dispatched PCB already
+	has its own PC in its context.
 */
 void pseudoIRET (Scheduler theScheduler) {
-	if (theScheduler->running != NULL) {
+	HOT_SCOPE(PSEUDO_IRET);
+	if (theScheduler->running != NULL && theScheduler->running == sysstackOwner) {
 		theScheduler->running->context->pc = sysstack;
 	}
+	sysstackOwner = NULL;
+}
+
+
+/*
+	Samples the queue sizes into the metrics gauges and writes every metric out
+	to the metrics file.
+*/
+void exportMetrics (Scheduler theScheduler) {
+	HOT_SCOPE(EXPORT_METRICS);
+	metricsSetLevels(theScheduler->ready->levels);
+	for (int i = 0; i < theScheduler->ready->levels; i++) {
+		metricsSetQueueLength(i, theScheduler->ready->queues[i]->size);
+	}
+	metricsSetBlocked(theScheduler->blocked->size);
+	metricsSetKilled(theScheduler->killed->size);
+	if (metricsPath != NULL && !metricsWrite(metricsPath)) {
+		LOG("Could not write metrics to %s\r\n", metricsPath);
+	}
+}
+
+
+/*
+	Updates the trace's counter tracks with the current length of every MLFQ
+	level and the Blocked queue.
+*/
+void traceSchedulerQueues (Scheduler theScheduler) {
+	if (!traceEnabled()) {
+		return;
+	}
+	for (int i = 0; i < theScheduler->ready->levels; i++) {
+		traceQueueLength(sim_tick, i, theScheduler->ready->queues[i]->size);
+	}
+	traceBlocked(sim_tick, theScheduler->blocked->size);
 }
 
 
 /*
 	This will construct the Scheduler, along with its numerous ReadyQueues and
-	important PCBs.
+	important PCBs. The MLFQ gets the configured number of levels and quanta.
 */
 Scheduler schedulerConstructor () {
 	Scheduler newScheduler = (Scheduler) malloc (sizeof(scheduler_s));
-	newScheduler->created = q_create();
-	newScheduler->killed = q_create();
-	newScheduler->blocked = q_create();
-	newScheduler->ready = pq_create();
+	newScheduler->created = q_create_kind(config.queue_kind);
+	newScheduler->killed = q_create_kind(config.queue_kind);
+	newScheduler->blocked = q_create_kind(config.queue_kind);
+	newScheduler->ready = pq_create_kind(config.queue_kind);
 	newScheduler->running = NULL;
 	newScheduler->interrupted = NULL;
 	newScheduler->isNew = 1;
+	configureScheduler(newScheduler);
 	
 	return newScheduler;
 }
 
 
+/*
+	Sets the MLFQ's levels and quanta from the config. It can be called on a
+	running Scheduler: PCBs on levels past the new last level move down to the
+	back of it and their wait there starts at sim_tick, so the last level stays
+	in the order ageMLFQ expects. With adaptive_quantum on, the levels keep the
+	quanta they were resized to.
+*/
+void configureScheduler (Scheduler theScheduler) {
+	PriorityQueue ready = theScheduler->ready;
+	int last = config.levels - 1;
+	PCB batch[PCB_BATCH];
+	unsigned int count;
+	for (int i = config.levels; i < ready->levels; i++) {
+		while ((count = q_dequeue_n(ready->queues[i], batch, PCB_BATCH)) > 0) {
+			for (unsigned int j = 0; j < count; j++) {
+				batch[j]->priority = last;
+				batch[j]->level_since = sim_tick;
+			}
+			q_enqueue_batch(ready->queues[last], batch, count);
+		}
+	}
+	pq_set_levels(ready, config.levels);
+	for (int i = 0; i < config.levels; i++) {
+		setQuantumSize(ready->queues[i], config.quantum[i]);
+	}
+	if (config.adaptive_quantum) {
+		adaptApply(ready);
+	}
+	if (theScheduler->running != NULL && theScheduler->running->priority > last) {
+		theScheduler->running->priority = last;
+	}
+}
+
+
 /*
 	This will do the opposite of the constructor with the exception of 
-	the interrupted PCB which checks for equivalancy of it and the running
-	PCB to see if they are pointing to the same freed process (so the program
-	doesn't crash).
+	the interrupted PCB, which is always either the running PCB or already
+	in one of the queues, so freeing it here would free it twice.
 */
 void schedulerDeconstructor (Scheduler theScheduler) {
 	q_destroy(theScheduler->created);
 	q_destroy(theScheduler->killed);
 	q_destroy(theScheduler->blocked);
 	pq_destroy(theScheduler->ready);
-	PCB_destroy(theScheduler->running);
-	if (theScheduler->interrupted == theScheduler->running) {
-		PCB_destroy(theScheduler->interrupted);
+	if (theScheduler->running != NULL) {
+		PCB_destroy(theScheduler->running);
 	}
 	free (theScheduler);
 }
@@ -547,11 +1120,212 @@ int isPrivileged(PCB pcb) {
 }
 
 
-void main () {
+/*
+	Copies the settings osLoop reads from globals out of the config.
+*/
+void applyConfig () {
+	arrivalLimit = config.max_pcb_total;
+	tickLimit = config.tick_limit;
+	metricsPath = config.metrics_file[0] ? config.metrics_file : NULL;
+	generator = config.use_generator ? &config.generator : NULL;
+}
+
+
+/*
+	Runs the scheduler. The options are:
+
+	-c <file>     load settings from a config file, see config.c
+	-o key=value  override one setting, after the config file is loaded
+	-g <settings> make arrivals with the generator, the same as the gen.* settings,
+	              e.g. -g arrival=mmpp,size=pareto,alpha=1.2,io=4
+	-r <file>     take arrivals from a recorded workload instead
+	-w <file>     record every arrival to a workload file
+	-t <file>     write a Chrome trace of the run
+	-e <file>     write where the run's ticks went as folded stacks for a flame graph
+	-b <file>     run the saturation benchmark and write its curve to the file
+	-s <file>     run the parameter sweep in the file, see sweep.c
+	-u <file>     search for the best settings as the file says, see tune.c
+	-f <tick>     fork the run at the tick into the branches given with -F, see whatif.c
+	-F <settings> add a branch with the ';' separated key=value settings
+	-k <file>     write a checkpoint of the run to the file at the tick given with -K
+	-R <file>     resume the run saved in a checkpoint, see checkpoint.c
+	-m <file>     run the microbenchmarks and write their results to the file, see microbench.c
+	-M <file>     run the end to end benchmark and write its results to the file, see macrobench.c
+	-B <file>     compare the microbenchmarks or the end to end benchmark against the results in the file
+	-T <percent>  how much worse than the baseline an end to end result may be before the run fails
+	-G <file>     benchmark the green thread runtime against pthreads and write its results to the file, see green.c
+	-p            print the settings that would be used and exit
+	-x            run the self checks, see selftest.c
+*/
+int main (int argc, char * argv[]) {
+	int opt, overrideCount = 0, printOnly = 0, selftest = 0, recording = 0; // recording: -t, -e or -w was given
+	const char * benchPath = NULL, * configPath = NULL, * sweepPath = NULL, * tunePath = NULL;
+	const char * microbenchPath = NULL, * macrobenchPath = NULL, * baselinePath = NULL, * greenPath = NULL;
+	double threshold = MACROBENCH_THRESHOLD;
+	const char ** overrides = malloc(argc * sizeof(char *));
+	char * overrideKind = malloc(argc); // the option each override came from
 	setvbuf(stdout, NULL, _IONBF, 0);
-	srand((unsigned) time(&t));
+	configDefaults(&config);
+	while ((opt = getopt(argc, argv, "c:o:g:r:w:t:e:b:s:u:f:F:k:K:R:m:M:B:T:G:px")) != -1) {
+		if (opt == 'c') {
+			configPath = optarg;
+		} else if (opt == 'o' || opt == 'g') {
+			overrideKind[overrideCount] = opt;
+			overrides[overrideCount++] = optarg;
+		} else if (opt == 't') {
+			recording = 1;
+			if (!traceOpen(optarg)) {
+				fprintf(stderr, "Could not open trace file %s\r\n", optarg);
+				return 1;
+			}
+		} else if (opt == 'e') {
+			recording = 1;
+			if (!flameOpen(optarg)) {
+				fprintf(stderr, "Could not open flame graph file %s\r\n", optarg);
+				return 1;
+			}
+		} else if (opt == 'r') {
+			replay = workloadOpen(optarg);
+			if (replay == NULL) {
+				fprintf(stderr, "Could not open workload %s\r\n", optarg);
+				return 1;
+			}
+		} else if (opt == 'w') {
+			recording = 1;
+			recorder = recorderOpen(optarg);
+			if (recorder == NULL) {
+				fprintf(stderr, "Could not open workload %s for recording\r\n", optarg);
+				return 1;
+			}
+		} else if (opt == 'b') {
+			benchPath = optarg;
+		} else if (opt == 's') {
+			sweepPath = optarg;
+		} else if (opt == 'u') {
+			tunePath = optarg;
+		} else if (opt == 'f') {
+			whatIf.at = strtoul(optarg, NULL, 10);
+		} else if (opt == 'F') {
+			if (!whatIfAdd(optarg)) {
+				fprintf(stderr, "At most %d branches\r\n", WHATIF_MAX_BRANCHES);
+				return 1;
+			}
+		} else if (opt == 'k') {
+			checkpointPath = optarg;
+		} else if (opt == 'K') {
+			checkpointTick = strtoul(optarg, NULL, 10);
+		} else if (opt == 'R') {
+			restoreFrom = checkpointOpen(optarg);
+			if (restoreFrom == NULL) {
+				fprintf(stderr, "Could not open checkpoint %s\r\n", optarg);
+				return 1;
+			}
+		} else if (opt == 'm') {
+			microbenchPath = optarg;
+		} else if (opt == 'M') {
+			macrobenchPath = optarg;
+		} else if (opt == 'B') {
+			baselinePath = optarg;
+		} else if (opt == 'T') {
+			threshold = strtod(optarg, NULL);
+		} else if (opt == 'G') {
+			greenPath = optarg;
+		} else if (opt == 'p') {
+			printOnly = 1;
+		} else if (opt == 'x') {
+			selftest = 1;
+		} else {
+			fprintf(stderr, "Usage: %s [-c config] [-o key=value]... [-r replay.wl | -g settings] [-w record.wl] [-t trace.json] [-e stacks.folded] [-b curve.csv] [-s sweep.spec] [-u tune.spec] [-f tick -F settings...] [-k checkpoint -K tick] [-R checkpoint] [-m results.csv | -M results.csv [-T percent]] [-B baseline.csv] [-G green.csv] [-p] [-x]\r\n", argv[0]);
+			return 1;
+		}
+	}
+	if (restoreFrom != NULL) {
+		config = restoreFrom->header->config;
+	}
+	if (configPath != NULL && !configLoad(&config, configPath)) {
+		return 1;
+	}
+	for (int i = 0; i < overrideCount; i++) {
+		if (overrideKind[i] == 'g') {
+			config.use_generator = 1;
+			if (!generatorParse(&config.generator, overrides[i])) {
+				fprintf(stderr, "Bad generator settings %s\r\n", overrides[i]);
+				return 1;
+			}
+		} else if (!configSetPair(&config, overrides[i])) {
+			fprintf(stderr, "Bad setting %s\r\n", overrides[i]);
+			return 1;
+		}
+	}
+	free(overrides);
+	free(overrideKind);
+	if (recording && (sweepPath != NULL || tunePath != NULL)) {
+		fprintf(stderr, "A sweep or tuner can not be traced or recorded, its runs happen in other processes\r\n");
+		return 1;
+	}
+	// the sweep and tuner finish each config themselves, after their own settings
+	if (sweepPath != NULL) {
+		return runSweep(sweepPath, &config) ? 0 : 1;
+	}
+	if (tunePath != NULL) {
+		return runTuner(tunePath, &config) ? 0 : 1;
+	}
+	baseConfig = config;
+	for (int i = 0; i < whatIf.count; i++) {
+		SchedConfig_s branched = config;
+		if (!branchConfig(&branched, whatIf.settings[i])) {
+			return 1;
+		}
+	}
+	if (whatIf.count > 0 && whatIf.at == 0) {
+		fprintf(stderr, "Branches need a tick to fork at, given with -f\r\n");
+		return 1;
+	}
+	if (!configFinish(&config)) {
+		return 1;
+	}
+	if (printOnly) {
+		configPrint(&config, stdout);
+		return 0;
+	}
+	applyConfig();
+	if (replay == NULL && config.replay_file[0]) {
+		replay = workloadOpen(config.replay_file);
+		if (replay == NULL) {
+			fprintf(stderr, "Could not open workload %s\r\n", config.replay_file);
+			return 1;
+		}
+	}
+	if (benchPath != NULL) {
+		return runSaturation(benchPath, &config.generator) ? 0 : 1;
+	}
+	if (microbenchPath != NULL) {
+		return runMicrobench(microbenchPath, baselinePath) ? 0 : 1;
+	}
+	if (macrobenchPath != NULL) {
+		return runMacrobench(macrobenchPath, baselinePath, threshold) ? 0 : 1;
+	}
+	if (greenPath != NULL) {
+		return runGreenBench(greenPath) ? 0 : 1;
+	}
+	if (selftest) {
+		return runSelftests() ? 0 : 1;
+	}
+	rngSeed(config.seed ? config.seed : (unsigned long long) time(&t));
 	sysstack = 0;
 	switchCalls = 0;
 	currQuantumSize = 0;
 	osLoop();
+	whatIfFinish();
+	flameClose();
+	if (restoreFrom != NULL) {
+		checkpointClose(restoreFrom);
+	}
+	if (replay != NULL) {
+		workloadClose(replay);
+	}
+	if (recorder != NULL) {
+		recorderClose(recorder);
+	}
+	return 0;
 }
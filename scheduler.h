@@ -16,16 +16,39 @@
 
 //includes
 #include "priority_queue.h"
+#include "latency_stats.h"
+#include "metrics.h"
+#include "trace_export.h"
+#include "flame_export.h"
+#include "workload.h"
+#include "workload_gen.h"
+#include "rng.h"
+#include "sim_log.h"
+#include "saturation.h"
+#include "config.h"
+#include "sweep.h"
+#include "tune.h"
+#include "whatif.h"
+#include "checkpoint.h"
+#include "microbench.h"
+#include "macrobench.h"
+#include "hotpath.h"
+#include "timer_wheel.h"
+#include "quantum_adapt.h"
+#include "green.h"
+#include "selftest.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
 
 
 //defines
 #define MAX_PCB_TOTAL 30
 #define RESET_COUNT 15
 #define MAX_PCB_IN_ROUND 5
+#define PCB_BATCH 64 // PCBs moved from one queue to another at a time
 #define MAX_PC_JUMP 4000
 #define MIN_PC_JUMP 3000
 #define PC_JUMP_LIMIT 999
@@ -41,9 +64,46 @@
 #define RANDOM_VALUE 101
 #define TOTAL_TERMINATED 10
 #define MAX_PRIVILEGE 4
+#define QUANTUM_CARRY_OVER 1
+#define IO_COALESCE_COUNT 1
+#define IO_COALESCE_TICKS 0
+#define TICKLESS_IDLE 1
+#define GREEN_WORKERS 4
+#define GREEN_TICK_US 10
+#define GREEN_RESET 10000 // a tenth of a second, at GREEN_TICK_US
+#define AGING 0
+#define ADAPTIVE_QUANTUM 0
+#define ADAPT_TARGET 90
+#define AGING_AGE 1000 // ticks a PCB waits at a level before aging moves it up, unless set
+
+
+//enums
+/* The timers osLoop keeps in its timer wheel, all on sim_tick. */
+enum loop_timer {
+	TIMER_ARRIVAL, // the next streamed arrival
+	TIMER_METRICS,
+	TIMER_FORK, // the what-if branches fork
+	TIMER_CHECKPOINT,
+	TIMER_LIMIT, // the tick limit
+	LOOP_TIMER_COUNT
+};
 
 
 //structs
+/* Totals for one run of osLoop that are not kept anywhere else. */
+typedef struct run_stats {
+	unsigned int start_tick; // tick the totals were started at
+	unsigned long long idle_ticks;
+	unsigned long long io_completions; // PCBs woken by I/O interrupts
+	unsigned long long io_interrupts; // I/O interrupts, each waking one or more PCBs
+	unsigned long long io_delay_ticks; // ticks completed I/O waited for its interrupt
+	double samples; // MLFQ length samples, fitted against time by readyGrowth
+	double sum_t;
+	double sum_len;
+	double sum_tt;
+	double sum_tlen;
+} RunStats_s;
+
 typedef struct scheduler {
 	ReadyQueue created;
 	ReadyQueue killed;
@@ -60,6 +120,24 @@ typedef scheduler_s * Scheduler;
 //declarations
 int makePCBList (Scheduler);
 
+int streamArrivals (Scheduler, int);
+
+int streamDone (int);
+
+int madeEnough (int);
+
+int replayRunsOn ();
+
+void armLoopTimers (int, int);
+
+void armArrivalTimer (int, int);
+
+int loopTimerDue (enum loop_timer);
+
+void skipIdleTicks (Scheduler, int *, int);
+
+void admitCreated (Scheduler);
+
 unsigned int runProcess (unsigned int, int);
 
 void pseudoISR (Scheduler, int);
@@ -72,6 +150,10 @@ void pseudoIRET (Scheduler);
 
 void printSchedulerState (Scheduler);
 
+void exportMetrics (Scheduler);
+
+void traceSchedulerQueues (Scheduler);
+
 Scheduler schedulerConstructor ();
 
 void schedulerDeconstructor (Scheduler);
@@ -82,15 +164,51 @@ void terminate(Scheduler theScheduler);
 
 void resetMLFQ(Scheduler theScheduler);
 
+void ageMLFQ (Scheduler);
+
 void resetReadyQueue (ReadyQueue queue);
 
 void osLoop ();
 
+void resetSimulation ();
+
+void sampleReadyLength (Scheduler);
+
+double readyGrowth ();
+
+void applyConfig ();
+
+void configureScheduler (Scheduler);
+
 int timerInterrupt (int);
 
+void startQuantum (PCB, unsigned int);
+
 int ioTrap (PCB);
 
 int ioInterrupt (ReadyQueue);
 
+void ioCoalesceReport (FILE *);
+
+
+//globals shared with the benchmark and sweep modes
+extern unsigned int sim_tick;
+extern unsigned int sysstack;
+extern PCB sysstackOwner;
+extern PCB privileged[4];
+extern int currQuantumSize;
+extern int liveTerminating;
+extern int io_timer;
+extern int ioPending;
+extern unsigned int ioPendingSince;
+extern unsigned long long ioPendingTicks;
+extern int switchCalls;
+extern int arrivalLimit;
+extern unsigned int tickLimit;
+extern const char * metricsPath;
+extern RunStats_s runStats;
+extern Generator generator;
+extern Workload replay;
+extern WorkloadRecorder recorder;
 
 #endif
\ No newline at end of file
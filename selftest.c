@@ -0,0 +1,600 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the defined functions declared in the selftest.h header file.
+	Every run is made in a child process on the settings given with -c and -o,
+	with logging and the metrics file off, so each one starts from the same state
+	and none of them leave anything behind here. What a run reports at its end,
+	its totals, counters and latency percentiles, is what two runs are compared
+	on.
+*/
+
+#include "selftest.h"
+#include "scheduler.h"
+#include <limits.h>
+#include <sys/wait.h>
+
+
+const Selftest_s selftests[] = {
+	{"replay", checkReplay},
+	{"checkpoint", checkCheckpoint},
+	{"queues", checkQueues},
+	{"histogram", checkHistogram},
+	{"timer wheel", checkTimerWheel},
+	{"config", checkConfig},
+};
+
+/* Settings the config check gives, one case each, split at the ';'s. */
+const char * const configCases[] = {
+	"",
+	"levels=6;ladder.base=200;ladder.mult=1.5;demote.5=2;promote.0=0;aging=1;age.3=77;queue=ring",
+	"levels=3;quantum=10,20,4294967295;reset_count=2147483647;tick_limit=4294967295;seed=18446744073709551615",
+	"workload=" SELFTEST_GENERATOR ";metrics_file=/tmp/metrics.txt;adaptive_quantum=1;adapt_target=90",
+	"gen.arrival=poisson;gen.rate=0.25;io_coalesce_count=4;io_coalesce_ticks=20;tickless_idle=1",
+	"workload=" CONFIG_REPLAY_PREFIX "/tmp/trace.wl;green_workers=2;green_reset=0;quantum_carry_over=1",
+};
+
+
+/*
+	Writes what the run that just ended reports to out.
+*/
+void selftestReport (FILE * out) {
+	fprintf(out, "tick %u idle %llu io %llu %llu %llu\n", sim_tick, runStats.idle_ticks,
+		runStats.io_completions, runStats.io_interrupts, runStats.io_delay_ticks);
+	for (int i = 0; i < MET_COUNTER_COUNT; i++) {
+		fprintf(out, "%llu ", metricsCounter(i));
+	}
+	fprintf(out, "\n");
+	latencyReport(out);
+	ioCoalesceReport(out);
+}
+
+
+/*
+	Makes the run in this process, which must be a child of the check, writes
+	its report to fd and exits.
+*/
+void selftestChild (const SelftestRun_s * run, int fd) {
+	FILE * out;
+
+	// the files belong to the parent
+	traceDetach();
+	flameDetach();
+	if (recorder != NULL) {
+		recorderDetach(recorder);
+		recorder = NULL;
+	}
+	replay = NULL;
+	checkpointPath = NULL;
+	whatIf.count = 0;
+
+	resetSimulation();
+	rngSeed(SELFTEST_SEED);
+	generator = NULL;
+	arrivalLimit = SELFTEST_PCBS;
+	tickLimit = 0;
+	if (run->generated) {
+		// in the config, where a restored checkpoint puts the generator's place in time
+		generatorInit(&config.generator);
+		generatorParse(&config.generator, SELFTEST_GENERATOR);
+		generator = &config.generator;
+		arrivalLimit = INT_MAX;
+		tickLimit = SELFTEST_TICKS;
+	}
+	logEnabled = 0;
+	metricsPath = NULL;
+	checkpointPath = run->checkpoint;
+	checkpointTick = run->checkpoint_tick;
+	if (run->restore != NULL && (restoreFrom = checkpointOpen(run->restore)) == NULL) {
+		_exit(1);
+	}
+	if (freopen("/dev/null", "w", stderr) == NULL) { // the checkpoints it writes are checked, not shown
+		_exit(1);
+	}
+	if (run->record != NULL && (recorder = recorderOpen(run->record)) == NULL) {
+		_exit(1);
+	}
+	if (run->replay != NULL) {
+		if ((replay = workloadOpen(run->replay)) == NULL) {
+			_exit(1);
+		}
+		generator = NULL;
+	}
+
+	osLoop();
+	if (recorder != NULL) {
+		recorderClose(recorder);
+	}
+	out = fdopen(fd, "w");
+	if (out == NULL) {
+		_exit(1);
+	}
+	selftestReport(out);
+	_exit(fclose(out) == 0 ? 0 : 1);
+}
+
+
+/*
+	Makes the run in a child process and points report at what it reported, which
+	the caller frees, and length at its length. Returns 1 on success, 0 if the run
+	could not be made or did not finish.
+*/
+int selftestRun (const SelftestRun_s * run, char ** report, size_t * length) {
+	size_t size = 4096;
+	ssize_t got;
+	int fd[2], status = 1;
+	pid_t pid;
+
+	*report = malloc(size);
+	*length = 0;
+	if (*report == NULL) {
+		return 0;
+	}
+	fflush(NULL);
+	if (pipe(fd) != 0) {
+		return 0;
+	}
+	pid = fork();
+	if (pid == 0) {
+		close(fd[0]);
+		selftestChild(run, fd[1]);
+	}
+	close(fd[1]);
+	if (pid < 0) {
+		close(fd[0]);
+		return 0;
+	}
+	while ((got = read(fd[0], *report + *length, size - *length)) > 0) {
+		*length += got;
+		if (*length == size) {
+			char * grown = realloc(*report, size * 2);
+			if (grown == NULL) {
+				break;
+			}
+			*report = grown;
+			size *= 2;
+		}
+	}
+	close(fd[0]);
+	return waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0 && got == 0;
+}
+
+
+/*
+	Makes both runs and returns 1 if they reported the same, 0 otherwise. The
+	first line that differs is printed.
+*/
+int sameRuns (const SelftestRun_s * first, const SelftestRun_s * second) {
+	char * reports[2] = {NULL, NULL};
+	size_t lengths[2];
+	int same = selftestRun(first, &reports[0], &lengths[0]) && selftestRun(second, &reports[1], &lengths[1]);
+	if (!same) {
+		printf("  a run did not finish\r\n");
+	} else if (lengths[0] != lengths[1] || memcmp(reports[0], reports[1], lengths[0]) != 0) {
+		size_t at = 0, line = 0;
+		while (at < lengths[0] && at < lengths[1] && reports[0][at] == reports[1][at]) {
+			if (reports[0][at++] == '\n') {
+				line = at;
+			}
+		}
+		printf("  they differ from: %.*s\r\n", (int) strcspn(reports[0] + line, "\n"), reports[0] + line);
+		same = 0;
+	}
+	free(reports[0]);
+	free(reports[1]);
+	return same;
+}
+
+
+/*
+	Records a run and replays it, once with PCBs made at the MLFQ resets and
+	once generated and stopped at a tick limit. A replay draws nothing from the
+	arrival stream and the same from the main one, so it must report the same
+	as the run it was recorded from.
+*/
+int checkReplay () {
+	int passed = 1;
+	for (int generated = 0; generated <= 1; generated++) {
+		char path[] = "/tmp/selftest-XXXXXX";
+		int fd = mkstemp(path);
+		SelftestRun_s recorded = {generated, path, NULL, NULL, 0, NULL};
+		SelftestRun_s replayed = {generated, NULL, path, NULL, 0, NULL};
+		if (fd < 0) {
+			printf("  could not make a workload file\r\n");
+			return 0;
+		}
+		close(fd);
+		if (!sameRuns(&recorded, &replayed)) {
+			printf("  the replay of the %s run is not the same\r\n", generated ? "generated" : "made");
+			passed = 0;
+		}
+		unlink(path);
+	}
+	return passed;
+}
+
+
+/*
+	Returns 1 if both files could be read and hold the same bytes, 0 otherwise.
+*/
+int sameFiles (const char * first, const char * second) {
+	FILE * in[2] = {fopen(first, "rb"), fopen(second, "rb")};
+	int same = in[0] != NULL && in[1] != NULL, a, b;
+	while (same) {
+		a = fgetc(in[0]);
+		b = fgetc(in[1]);
+		same = a == b;
+		if (a == EOF) {
+			break;
+		}
+	}
+	for (int i = 0; i < 2; i++) {
+		if (in[i] != NULL) {
+			fclose(in[i]);
+		}
+	}
+	return same;
+}
+
+
+/*
+	Makes the run, ignoring what it reports. Returns 1 if it finished, 0
+	otherwise.
+*/
+int finishes (const SelftestRun_s * run) {
+	char * report;
+	size_t length;
+	int finished = selftestRun(run, &report, &length);
+	free(report);
+	return finished;
+}
+
+
+/*
+	Returns 1 if the file holds a checkpoint, 0 otherwise, as when the run never
+	got to the tick it was to be saved at.
+*/
+int wroteCheckpoint (const char * path) {
+	Checkpoint saved = checkpointOpen(path);
+	if (saved == NULL) {
+		return 0;
+	}
+	checkpointClose(saved);
+	return 1;
+}
+
+
+/*
+	Saves a run at SELFTEST_FIRST_SAVE and again, in another run, at
+	SELFTEST_SECOND_SAVE, then resumes the first checkpoint and saves it at
+	SELFTEST_SECOND_SAVE too. The resumed run must carry on exactly as the
+	straight one did, so the two later checkpoints must be the same file.
+*/
+int checkCheckpoint () {
+	int passed = 1;
+	for (int generated = 0; generated <= 1; generated++) {
+		char paths[3][24] = {"/tmp/selftest-XXXXXX", "/tmp/selftest-XXXXXX", "/tmp/selftest-XXXXXX"};
+		SelftestRun_s first = {generated, NULL, NULL, paths[0], SELFTEST_FIRST_SAVE, NULL};
+		SelftestRun_s straight = {generated, NULL, NULL, paths[1], SELFTEST_SECOND_SAVE, NULL};
+		SelftestRun_s resumed = {generated, NULL, NULL, paths[2], SELFTEST_SECOND_SAVE, paths[0]};
+		int made = 0;
+		for (int i = 0; i < 3; i++) {
+			int fd = mkstemp(paths[i]);
+			if (fd >= 0) {
+				close(fd);
+				made++;
+			}
+		}
+		if (made < 3) {
+			printf("  could not make the checkpoint files\r\n");
+			passed = 0;
+		} else if (!finishes(&first) || !finishes(&straight) || !finishes(&resumed)) {
+			printf("  a run did not finish\r\n");
+			passed = 0;
+		} else if (!wroteCheckpoint(paths[1]) || !wroteCheckpoint(paths[2])) {
+			printf("  a run did not write its checkpoint\r\n");
+			passed = 0;
+		} else if (!sameFiles(paths[1], paths[2])) {
+			printf("  the %s run resumed from tick %u is not where the straight one is at tick %u\r\n",
+				generated ? "generated" : "made", SELFTEST_FIRST_SAVE, SELFTEST_SECOND_SAVE);
+			passed = 0;
+		}
+		for (int i = 0; i < 3; i++) {
+			unlink(paths[i]);
+		}
+	}
+	return passed;
+}
+
+
+/*
+	Appends a PCB of a queue being walked to the QueueContents_s in arg.
+*/
+void collectPCB (PCB pcb, void * arg) {
+	QueueContents_s * contents = arg;
+	if (contents->count < SELFTEST_QUEUE_MAX) {
+		contents->pcbs[contents->count] = pcb;
+	}
+	contents->count++;
+}
+
+
+/*
+	Returns 1 if both queues hold the same PCBs in the same order, 0 otherwise.
+*/
+int sameQueues (ReadyQueue first, ReadyQueue second) {
+	static QueueContents_s contents[2];
+	contents[0].count = 0;
+	contents[1].count = 0;
+	q_visit(first, collectPCB, &contents[0]);
+	q_visit(second, collectPCB, &contents[1]);
+	return first->size == second->size && contents[0].count == first->size && contents[1].count == second->size
+		&& contents[0].count <= SELFTEST_QUEUE_MAX
+		&& memcmp(contents[0].pcbs, contents[1].pcbs, contents[0].count * sizeof(PCB)) == 0
+		&& q_peek(first) == q_peek(second);
+}
+
+
+/*
+	Runs the same random mix of single and batch enqueues and dequeues, and
+	splices both ways between the kinds, on a list queue and a ring queue, and
+	checks after every step that they hand back and hold the same PCBs.
+*/
+int checkQueues () {
+	static PCB_s pcbs[SELFTEST_QUEUE_PCBS];
+	PCB in[SELFTEST_QUEUE_BATCH], out[2][SELFTEST_QUEUE_BATCH];
+	ReadyQueue main[2] = {q_create_kind(Q_LIST), q_create_kind(Q_RING)};
+	ReadyQueue side[2] = {q_create_kind(Q_LIST), q_create_kind(Q_RING)};
+	unsigned int next = 0, step;
+	int passed = 1;
+
+	if (main[0] == NULL || main[1] == NULL || side[0] == NULL || side[1] == NULL) {
+		printf("  could not make the queues\r\n");
+		return 0;
+	}
+	rngSeed(SELFTEST_SEED);
+	for (step = 0; step < SELFTEST_QUEUE_STEPS && passed; step++) {
+		unsigned int op = rngRange(6), n = 1 + rngRange(SELFTEST_QUEUE_BATCH);
+		if (main[0]->size > SELFTEST_QUEUE_PCBS) {
+			op = 3; // keep them short enough to compare at every step
+		}
+		unsigned int got[2] = {0, 0};
+		for (unsigned int i = 0; i < n; i++) {
+			in[i] = &pcbs[(next + i) % SELFTEST_QUEUE_PCBS];
+		}
+		for (int kind = 0; kind < 2; kind++) {
+			if (op == 0) {
+				got[kind] = q_enqueue(main[kind], in[0]);
+			} else if (op == 1) {
+				out[kind][0] = q_dequeue(main[kind]);
+			} else if (op == 2) {
+				got[kind] = q_enqueue_batch(main[kind], in, n);
+			} else if (op == 3) {
+				got[kind] = q_dequeue_n(main[kind], out[kind], n);
+			} else if (op == 4) {
+				got[kind] = q_enqueue_batch(side[kind], in, n);
+			} else {
+				q_splice(main[kind], side[1 - kind]); // a ring into the list, the list into the ring
+			}
+		}
+		next += n;
+		if (got[0] != got[1] || (op == 1 && out[0][0] != out[1][0])
+				|| (op == 3 && memcmp(out[0], out[1], got[0] * sizeof(PCB)) != 0)
+				|| !sameQueues(main[0], main[1]) || side[0]->size != side[1]->size) {
+			printf("  the list and ring queues differ after step %u, operation %u\r\n", step, op);
+			passed = 0;
+		}
+	}
+	for (int kind = 0; kind < 2; kind++) {
+		// the PCBs are not the queues' to free
+		while (q_dequeue_n(main[kind], out[kind], SELFTEST_QUEUE_BATCH) > 0);
+		while (q_dequeue_n(side[kind], out[kind], SELFTEST_QUEUE_BATCH) > 0);
+		q_destroy(main[kind]);
+		q_destroy(side[kind]);
+	}
+	return passed;
+}
+
+
+/*
+	Orders two unsigned ints for qsort.
+*/
+int compareValues (const void * first, const void * second) {
+	unsigned int a = *(const unsigned int *) first, b = *(const unsigned int *) second;
+	return (a > b) - (a < b);
+}
+
+
+/*
+	Records values of every magnitude into a histogram and checks its
+	percentiles against the exact ones: a reported value is the top of the
+	exact value's bucket, so it is never below it and at most
+	1/HIST_HALF_COUNT above it.
+*/
+int checkHistogram () {
+	static unsigned int values[SELFTEST_HIST_VALUES];
+	const double percentiles[] = {0.1, 1, 25, 50, 90, 99, 99.9, 100};
+	LatencyHist_s hist;
+	double sum = 0;
+	int passed = 1;
+
+	rngSeed(SELFTEST_SEED);
+	histReset(&hist);
+	for (int i = 0; i < SELFTEST_HIST_VALUES; i++) {
+		values[i] = rngRange(2u << rngRange(31));
+		histRecord(&hist, values[i]);
+		sum += values[i];
+	}
+	qsort(values, SELFTEST_HIST_VALUES, sizeof(values[0]), compareValues);
+	for (size_t i = 0; i < sizeof(percentiles) / sizeof(percentiles[0]); i++) {
+		unsigned long long target = (unsigned long long) (percentiles[i] / 100.0 * SELFTEST_HIST_VALUES + 0.5);
+		unsigned int exact = values[(target < 1 ? 1 : target) - 1];
+		unsigned int reported = histValueAtPercentile(&hist, percentiles[i]);
+		if (reported < exact || reported - exact > exact / HIST_HALF_COUNT) {
+			printf("  p%g is %u, the exact value is %u\r\n", percentiles[i], reported, exact);
+			passed = 0;
+		}
+	}
+	if (hist.total != SELFTEST_HIST_VALUES || hist.max != values[SELFTEST_HIST_VALUES - 1]
+			|| histMean(&hist) != sum / SELFTEST_HIST_VALUES) {
+		printf("  the count, mean or max is not exact\r\n");
+		passed = 0;
+	}
+	return passed;
+}
+
+
+/*
+	Counts a timer that goes off at any tick but its deadline, or that was not
+	set, and marks it no longer set.
+*/
+void fireWheelTimer (TimerNode node, void * arg) {
+	WheelTimer_s * timer = (WheelTimer_s *) node;
+	WheelCheck_s * check = arg;
+	if (!timer->armed || node->deadline != timer->deadline || check->wheel.now != timer->deadline) {
+		check->wrong++;
+	}
+	timer->armed = 0;
+}
+
+
+/*
+	Sets, cancels and resets timers at random while moving a timer wheel on by
+	random steps, from one tick to a million, and checks after each step that
+	every timer went off at its deadline and none is left behind, and that the
+	wheel's next deadline is the soonest one set.
+*/
+int checkTimerWheel () {
+	static WheelTimer_s timers[SELFTEST_WHEEL_TIMERS];
+	static WheelCheck_s check;
+	unsigned long long soonest;
+	int passed = 1;
+
+	rngSeed(SELFTEST_SEED);
+	memset(timers, 0, sizeof(timers));
+	check.wrong = 0;
+	twInit(&check.wheel, rngRange(1u << 31));
+	for (int step = 0; step < SELFTEST_WHEEL_STEPS && passed; step++) {
+		WheelTimer_s * timer = &timers[rngRange(SELFTEST_WHEEL_TIMERS)];
+		switch (rngRange(3)) {
+			case 0: // set or reset it, up to 2^24 ticks ahead
+				timer->deadline = check.wheel.now + 1 + rngRange(2u << rngRange(24));
+				twAdd(&check.wheel, &timer->node, timer->deadline);
+				timer->armed = 1;
+				break;
+			case 1:
+				twCancel(&check.wheel, &timer->node);
+				timer->armed = 0;
+				break;
+			default:
+				twAdvance(&check.wheel, check.wheel.now + rngRange(1u << rngRange(20)), fireWheelTimer, &check);
+				break;
+		}
+
+		soonest = TW_NEVER;
+		for (int i = 0; i < SELFTEST_WHEEL_TIMERS; i++) {
+			if (timers[i].armed && timers[i].deadline <= check.wheel.now) {
+				printf("  a timer due at %u has not gone off at %u\r\n", timers[i].deadline, check.wheel.now);
+				passed = 0;
+			} else if (timers[i].armed && timers[i].deadline < soonest) {
+				soonest = timers[i].deadline;
+			}
+		}
+		if (check.wrong > 0) {
+			printf("  %u timers went off at the wrong tick\r\n", check.wrong);
+			passed = 0;
+		}
+		if (twNextDeadline(&check.wheel) != soonest) {
+			printf("  the next deadline is %llu, the soonest timer is at %llu\r\n", twNextDeadline(&check.wheel), soonest);
+			passed = 0;
+		}
+	}
+	return passed;
+}
+
+
+/*
+	Writes the config to the given file. Returns 1 on success, 0 otherwise.
+*/
+int printConfig (SchedConfig cfg, const char * path) {
+	FILE * out = fopen(path, "w");
+	if (out == NULL) {
+		return 0;
+	}
+	configPrint(cfg, out);
+	return fclose(out) == 0;
+}
+
+
+/*
+	Gives each case's settings to a default config, prints it, loads what was
+	printed into another and prints that. configPrint writes what configLoad
+	reads, so both must print the same and take their arrivals from the same
+	place, which the printout alone would miss if it left the workload out.
+*/
+int checkConfig () {
+	int passed = 1;
+	for (size_t i = 0; i < sizeof(configCases) / sizeof(configCases[0]); i++) {
+		char paths[2][24] = {"/tmp/selftest-XXXXXX", "/tmp/selftest-XXXXXX"};
+		char settings[CONFIG_MAX_LINE];
+		SchedConfig_s given, loaded;
+		int taken = 1, made = 0;
+		for (int j = 0; j < 2; j++) {
+			int fd = mkstemp(paths[j]);
+			if (fd >= 0) {
+				close(fd);
+				made++;
+			}
+		}
+		configDefaults(&given);
+		configDefaults(&loaded);
+		strcpy(settings, configCases[i]);
+		for (char * pair = strtok(settings, ";"); pair != NULL; pair = strtok(NULL, ";")) {
+			taken = taken && configSetPair(&given, pair);
+		}
+
+		if (made < 2) {
+			printf("  could not make the config files\r\n");
+			passed = 0;
+		} else if (!taken || !configFinish(&given)) {
+			printf("  the settings \"%s\" were not taken\r\n", configCases[i]);
+			passed = 0;
+		} else if (!printConfig(&given, paths[0]) || !configLoad(&loaded, paths[0]) || !configFinish(&loaded)
+				|| !printConfig(&loaded, paths[1])) {
+			printf("  the printed config of \"%s\" could not be loaded\r\n", configCases[i]);
+			passed = 0;
+		} else if (!sameFiles(paths[0], paths[1]) || loaded.use_generator != given.use_generator
+				|| strcmp(loaded.replay_file, given.replay_file) != 0) {
+			printf("  the config of \"%s\" does not load back the same\r\n", configCases[i]);
+			passed = 0;
+		}
+		for (int j = 0; j < 2; j++) {
+			unlink(paths[j]);
+		}
+	}
+	return passed;
+}
+
+
+/*
+	Runs every check and prints whether each passed. Returns 1 if they all did,
+	0 otherwise.
+*/
+int runSelftests () {
+	int failed = 0;
+	for (size_t i = 0; i < sizeof(selftests) / sizeof(selftests[0]); i++) {
+		printf("%s\r\n", selftests[i].name);
+		if (selftests[i].check()) {
+			printf("  passed\r\n");
+		} else {
+			printf("  FAILED\r\n");
+			failed++;
+		}
+	}
+	if (failed > 0) {
+		printf("%d check%s failed\r\n", failed, failed == 1 ? "" : "s");
+		return 0;
+	}
+	return 1;
+}
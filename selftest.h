@@ -0,0 +1,111 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the definitions of structs and declarations of functions for the
+	selftest.c file. The self checks run the simulator against itself wherever two
+	ways of doing something must come out the same, and fail on any difference:
+
+		scheduler -x
+
+	Each check prints its name and whether it passed, and the run fails if any of
+	them did not.
+*/
+
+#ifndef SELFTEST_H
+#define SELFTEST_H
+
+//includes
+#include "fifo_queue.h"
+#include "timer_wheel.h"
+#include "config.h"
+#include <stddef.h>
+
+
+//defines
+#define SELFTEST_SEED 422
+#define SELFTEST_PCBS 400 // PCBs a run without a generator stops at
+#define SELFTEST_TICKS 300000 // tick limit of a generated run, reached before its arrivals run out
+#define SELFTEST_GENERATOR "arrival=mmpp,size=pareto,alpha=1.5,io=8"
+#define SELFTEST_FIRST_SAVE 100000 // ticks the checkpoint check saves a run at
+#define SELFTEST_SECOND_SAVE 200000
+#define SELFTEST_QUEUE_STEPS 50000 // operations the queue check makes on each queue
+#define SELFTEST_QUEUE_PCBS 1000 // PCBs it moves around, each may be queued more than once
+#define SELFTEST_QUEUE_BATCH 150 // the most a batch operation moves, over Q_SPLICE_BATCH
+#define SELFTEST_QUEUE_MAX (1 << 20) // longest queue it can compare
+#define SELFTEST_HIST_VALUES 100000 // values the histogram check records
+#define SELFTEST_WHEEL_STEPS 20000 // timers set, cancelled or moved on by the timer wheel check
+#define SELFTEST_WHEEL_TIMERS 1000
+
+
+//structs
+/* One run of the simulator, made in a child process. */
+typedef struct selftest_run {
+	int generated; // arrivals from SELFTEST_GENERATOR instead of makePCBList
+	const char * record; // workload file to record the arrivals to, or NULL
+	const char * replay; // workload file to take the arrivals from, or NULL
+	const char * checkpoint; // file to checkpoint the run to at checkpoint_tick, or NULL
+	unsigned int checkpoint_tick;
+	const char * restore; // checkpoint to resume the run from, or NULL
+} SelftestRun_s;
+
+/* The PCBs of a queue, front to back, as the queue check walks it. */
+typedef struct queue_contents {
+	PCB pcbs[SELFTEST_QUEUE_MAX];
+	unsigned int count;
+} QueueContents_s;
+
+/* A timer of the timer wheel check, with what it expects of it. */
+typedef struct wheel_timer {
+	TimerNode_s node; // first, so the node is the timer
+	unsigned int deadline;
+	int armed; // 1 from when it is set until it goes off or is cancelled
+} WheelTimer_s;
+
+typedef struct wheel_check {
+	TimerWheel_s wheel;
+	unsigned int wrong; // timers that went off when they should not have
+} WheelCheck_s;
+
+typedef struct selftest {
+	const char * name;
+	int (* check) ();
+} Selftest_s;
+
+
+//declarations
+int selftestRun (const SelftestRun_s *, char **, size_t *);
+
+int sameRuns (const SelftestRun_s *, const SelftestRun_s *);
+
+int checkReplay ();
+
+int sameFiles (const char *, const char *);
+
+int finishes (const SelftestRun_s *);
+
+int wroteCheckpoint (const char *);
+
+int checkCheckpoint ();
+
+void collectPCB (PCB, void *);
+
+int sameQueues (ReadyQueue, ReadyQueue);
+
+int checkQueues ();
+
+int compareValues (const void *, const void *);
+
+int checkHistogram ();
+
+void fireWheelTimer (TimerNode, void *);
+
+int checkTimerWheel ();
+
+int printConfig (SchedConfig, const char *);
+
+int checkConfig ();
+
+int runSelftests ();
+
+#endif
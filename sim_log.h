@@ -0,0 +1,24 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the logging macro used for all of the simulator's console
+	output. Benchmark and sweep runs turn logEnabled off so that printing does
+	not swamp the time spent scheduling.
+*/
+
+#ifndef SIM_LOG_H
+#define SIM_LOG_H
+
+//includes
+#include <stdio.h>
+
+
+//declarations
+extern int logEnabled;
+
+
+//defines
+#define LOG(...) do { if (logEnabled) printf(__VA_ARGS__); } while (0)
+
+#endif
@@ -0,0 +1,609 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the defined functions declared in the sweep.h header file.
+	Every run happens in its own forked process, so runs can not disturb each
+	other's globals and a crashing run only loses itself. A sweep spec is a config
+	file with two more kinds of line:
+
+		sweep ladder.base = 50 | 200 | 1000   # every value of a setting to try
+		sweep workload = size=pareto,alpha=1.2 | replay:trace.wl
+		sweep.seeds = 8                       # runs of each cell, seeds 1 to 8
+		sweep.seed = 1                        # first seed
+		sweep.jobs = 16                       # worker processes, all cores if unset
+		sweep.output = ladders.csv
+
+	Rows are appended and flushed to disk as runs finish. Running the same spec
+	again skips every run the output already has, so an interrupted sweep picks up
+	where it stopped.
+*/
+
+#include "sweep.h"
+#include "scheduler.h"
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <sys/wait.h>
+
+
+SweepTask sortTasks; // the tasks compareCost is ordering
+
+
+/*
+	Runs the scheduler once in this process with the given config and seed, with
+	logging and the metrics file off, and fills in result. A config without a tick
+	limit runs for SWEEP_DEFAULT_TICKS, and the generator runs for the whole tick
+	limit rather than stopping at max_pcb_total. The process must be a child of
+	the sweep or tuner, since the trace, flame graph and recording it was started
+	with are left to the parent. Returns 1 on success, 0 if the workload could
+	not be opened.
+*/
+int runConfig (SchedConfig cfg, unsigned long long seed, RunResult_s * result) {
+	// the files belong to the parent
+	traceDetach();
+	flameDetach();
+	if (recorder != NULL) {
+		recorderDetach(recorder);
+		recorder = NULL;
+	}
+	checkpointPath = NULL;
+	whatIf.count = 0;
+
+	config = *cfg;
+	if (config.tick_limit == 0) {
+		config.tick_limit = SWEEP_DEFAULT_TICKS;
+	}
+	applyConfig();
+	if (generator != NULL) {
+		arrivalLimit = INT_MAX;
+	}
+	logEnabled = 0;
+	metricsPath = NULL;
+	if (config.replay_file[0]) {
+		replay = workloadOpen(config.replay_file);
+		if (replay == NULL) {
+			return 0;
+		}
+	}
+	resetSimulation();
+	rngSeed(seed);
+	osLoop();
+	if (replay != NULL) {
+		workloadClose(replay);
+		replay = NULL;
+	}
+	collectResult(result);
+	return 1;
+}
+
+
+/*
+	Fills in result from the totals of the run that just ended, counted from
+	runStats.start_tick.
+*/
+void collectResult (RunResult_s * result) {
+	LatencyHist_s turnaround, response, responseIO;
+	double ticks = sim_tick - runStats.start_tick;
+
+	histReset(&turnaround);
+	histReset(&response);
+	histReset(&responseIO);
+	latencyMergeAll(LAT_TURNAROUND, -1, &turnaround);
+	latencyMergeAll(LAT_RESPONSE, -1, &response);
+	for (int i = 0; i < NUM_PRIORITIES; i++) {
+		histMerge(&responseIO, latencyHist(LAT_RESPONSE, i, JOB_IO_BOUND));
+	}
+	result->completed = 1000.0 * turnaround.total / ticks;
+	result->utilization = 1.0 - runStats.idle_ticks / ticks;
+	result->mean_turnaround = histMean(&turnaround);
+	result->p50_turnaround = histValueAtPercentile(&turnaround, 50.0);
+	result->p90_turnaround = histValueAtPercentile(&turnaround, 90.0);
+	result->p99_turnaround = histValueAtPercentile(&turnaround, 99.0);
+	result->p99_response = histValueAtPercentile(&response, 99.0);
+	result->p99_response_io = histValueAtPercentile(&responseIO, 99.0);
+	result->context_switches = 1000.0 * switchCalls / ticks;
+	result->terminated = turnaround.total;
+	result->isr_saved = 1000.0 * (runStats.io_completions - runStats.io_interrupts) / ticks;
+	result->mean_io_delay = runStats.io_completions ? (double) runStats.io_delay_ticks / runStats.io_completions : 0.0;
+}
+
+
+/*
+	Returns the named measurement from result, using the names of the sweep's CSV
+	columns without their units. Returns NAN for an unknown name.
+*/
+double resultMetric (RunResult_s * result, const char * name) {
+	if (strcmp(name, "completed") == 0) {
+		return result->completed;
+	} else if (strcmp(name, "utilization") == 0) {
+		return result->utilization;
+	} else if (strcmp(name, "mean_turnaround") == 0) {
+		return result->mean_turnaround;
+	} else if (strcmp(name, "p50_turnaround") == 0) {
+		return result->p50_turnaround;
+	} else if (strcmp(name, "p90_turnaround") == 0) {
+		return result->p90_turnaround;
+	} else if (strcmp(name, "p99_turnaround") == 0) {
+		return result->p99_turnaround;
+	} else if (strcmp(name, "p99_response") == 0) {
+		return result->p99_response;
+	} else if (strcmp(name, "p99_response_io") == 0) {
+		return result->p99_response_io;
+	} else if (strcmp(name, "context_switches") == 0) {
+		return result->context_switches;
+	} else if (strcmp(name, "terminated") == 0) {
+		return result->terminated;
+	} else if (strcmp(name, "isr_saved") == 0) {
+		return result->isr_saved;
+	} else if (strcmp(name, "mean_io_delay") == 0) {
+		return result->mean_io_delay;
+	}
+	return NAN;
+}
+
+
+/*
+	Roughly how long the given finished config takes to run. Every tick costs
+	about the same, and each arrival and quantum expiry adds queue work on top,
+	counted here as SWEEP_EVENT_COST ticks.
+*/
+double estimateCost (SchedConfig cfg) {
+	double ticks = cfg->tick_limit ? cfg->tick_limit : SWEEP_DEFAULT_TICKS;
+	double arrivals = 0;
+	Generator gen = &cfg->generator;
+	if (cfg->use_generator && gen->arrival == ARRIVAL_MMPP) {
+		arrivals = (gen->rate * gen->dwell[0] + gen->burst_rate * gen->dwell[1]) / (gen->dwell[0] + gen->dwell[1]);
+	} else if (cfg->use_generator) {
+		arrivals = gen->rate;
+	}
+	return ticks * (1.0 + SWEEP_EVENT_COST * (arrivals + 1.0 / cfg->quantum[0]));
+}
+
+
+/*
+	Returns the number of worker processes to use when none was asked for, one
+	per online core.
+*/
+int defaultJobs () {
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	return cores > 0 ? cores : 1;
+}
+
+
+/*
+	Orders task indices by descending cost, for qsort.
+*/
+int compareCost (const void * a, const void * b) {
+	double costA = sortTasks[*(const int *) a].cost;
+	double costB = sortTasks[*(const int *) b].cost;
+	return (costA < costB) - (costA > costB);
+}
+
+
+/*
+	Runs every pending task in a pool of up to jobs worker processes, longest
+	first, so the long runs do not all end up at the back of the queue with one
+	core busy and the rest idle. Each worker runs one task and sends its result
+	back through a pipe. done, if given, is called in this process as each task
+	finishes, whether it succeeded or not. Returns the number of tasks that
+	failed.
+*/
+int runTasks (SweepTask tasks, int count, int jobs, TaskDone done, void * arg) {
+	int * order = malloc(count * sizeof(int));
+	pid_t * pids = malloc(jobs * sizeof(pid_t));
+	int * pipes = malloc(jobs * sizeof(int));
+	int * slotTask = malloc(jobs * sizeof(int));
+	int next = 0, active = 0, failed = 0;
+
+	for (int i = 0; i < count; i++) {
+		order[i] = i;
+	}
+	sortTasks = tasks;
+	qsort(order, count, sizeof(int), compareCost);
+	for (int i = 0; i < jobs; i++) {
+		pids[i] = 0;
+	}
+
+	while (next < count || active > 0) {
+		while (active < jobs && next < count) {
+			int fd[2], slot = 0;
+			pid_t pid;
+			SweepTask task = &tasks[order[next]];
+			if (task->status != TASK_PENDING) {
+				next++;
+				continue;
+			}
+			if (pipe(fd) != 0) {
+				break;
+			}
+			fflush(NULL); // so the child has nothing buffered of the parent's to write again
+			pid = fork();
+			if (pid == 0) {
+				RunResult_s result;
+				close(fd[0]);
+				if (!runConfig(&task->config, task->seed, &result)
+						|| write(fd[1], &result, sizeof(result)) != sizeof(result)) {
+					_exit(1);
+				}
+				_exit(0);
+			}
+			close(fd[1]);
+			if (pid < 0) {
+				close(fd[0]);
+				break;
+			}
+			while (pids[slot] != 0) {
+				slot++;
+			}
+			pids[slot] = pid;
+			pipes[slot] = fd[0];
+			slotTask[slot] = order[next];
+			active++;
+			next++;
+		}
+		if (active == 0) {
+			// could not start a worker at all, give up on the rest
+			for (; next < count; next++) {
+				if (tasks[order[next]].status == TASK_PENDING) {
+					tasks[order[next]].status = TASK_FAILED;
+					failed++;
+				}
+			}
+			break;
+		}
+
+		int status, slot = 0;
+		pid_t pid = waitpid(-1, &status, 0);
+		if (pid < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+		while (slot < jobs && pids[slot] != pid) {
+			slot++;
+		}
+		if (slot == jobs) {
+			continue;
+		}
+		SweepTask task = &tasks[slotTask[slot]];
+		if (WIFEXITED(status) && WEXITSTATUS(status) == 0
+				&& read(pipes[slot], &task->result, sizeof(RunResult_s)) == sizeof(RunResult_s)) {
+			task->status = TASK_DONE;
+		} else {
+			task->status = TASK_FAILED;
+			failed++;
+		}
+		close(pipes[slot]);
+		pids[slot] = 0;
+		active--;
+		if (done != NULL) {
+			done(task, arg);
+		}
+	}
+
+	free(order);
+	free(pids);
+	free(pipes);
+	free(slotTask);
+	return failed;
+}
+
+
+/*
+	Adds a "key = value | value | ..." line to the sweep's axes. Every value is
+	tried against a scratch config so a typo is caught before anything runs.
+	Returns 1 on success, 0 otherwise.
+*/
+int parseAxis (Sweep sweep, char * line) {
+	SchedConfig_s scratch = sweep->base;
+	SweepAxis axis;
+	char * key, * value, * rest;
+	char * equals = strchr(line, '=');
+	if (equals == NULL || sweep->axis_count >= SWEEP_MAX_AXES) {
+		return 0;
+	}
+	*equals = '\0';
+	key = trim(line);
+	if (*key == '\0' || strlen(key) >= SWEEP_KEY_LENGTH) {
+		return 0;
+	}
+	axis = &sweep->axes[sweep->axis_count++];
+	strcpy(axis->key, key);
+	for (value = strtok_r(equals + 1, "|", &rest); value != NULL; value = strtok_r(NULL, "|", &rest)) {
+		value = trim(value);
+		if (axis->count >= SWEEP_MAX_VALUES || strchr(value, '"') != NULL
+				|| !configSet(&scratch, key, value)) {
+			return 0;
+		}
+		axis->values[axis->count++] = strdup(value);
+	}
+	return axis->count > 0;
+}
+
+
+/*
+	Sets one of the sweep.* settings. Returns 1 on success, 0 otherwise.
+*/
+int sweepSet (Sweep sweep, const char * key, const char * value) {
+	char * end;
+	unsigned long long number = strtoull(value, &end, 10);
+	if (strcmp(key, "output") == 0 && *value != '\0' && strlen(value) < CONFIG_PATH_LENGTH) {
+		strcpy(sweep->output, value);
+		return 1;
+	}
+	if (*end != '\0' || end == value) {
+		return 0;
+	}
+	if (strcmp(key, "seeds") == 0 && number >= 1) {
+		sweep->seeds = number;
+	} else if (strcmp(key, "seed") == 0) {
+		sweep->first_seed = number;
+	} else if (strcmp(key, "jobs") == 0) {
+		sweep->jobs = number ? number : defaultJobs();
+	} else {
+		return 0;
+	}
+	return 1;
+}
+
+
+/*
+	Loads the sweep spec at path, on top of the config already in sweep->base.
+	Returns 1 on success, 0 if the file could not be read or has a bad line,
+	which is reported with its line number.
+*/
+int sweepLoad (Sweep sweep, const char * path) {
+	char line[CONFIG_MAX_LINE];
+	char * comment, * setting, * value;
+	int lineNumber = 0, ok = 1;
+	FILE * in = fopen(path, "r");
+	if (in == NULL) {
+		fprintf(stderr, "Could not open sweep %s\r\n", path);
+		return 0;
+	}
+	memset(sweep->axes, 0, sizeof(sweep->axes));
+	sweep->axis_count = 0;
+	sweep->seeds = SWEEP_DEFAULT_SEEDS;
+	sweep->first_seed = SWEEP_FIRST_SEED;
+	sweep->jobs = defaultJobs();
+	strcpy(sweep->output, SWEEP_OUTPUT);
+	while (ok && fgets(line, sizeof(line), in) != NULL) {
+		lineNumber++;
+		comment = strchr(line, '#');
+		if (comment != NULL) {
+			*comment = '\0';
+		}
+		setting = trim(line);
+		if (*setting == '\0') {
+			continue;
+		}
+		if (strncmp(setting, "sweep ", 6) == 0) {
+			ok = parseAxis(sweep, setting + 6);
+		} else if (strncmp(setting, "sweep.", 6) == 0 && (value = strchr(setting, '=')) != NULL) {
+			*value++ = '\0';
+			ok = sweepSet(sweep, trim(setting + 6), trim(value));
+		} else {
+			ok = configSetPair(&sweep->base, setting);
+		}
+		if (!ok) {
+			fprintf(stderr, "%s:%d: bad setting \"%s\"\r\n", path, lineNumber, setting);
+		}
+	}
+	fclose(in);
+	return ok;
+}
+
+
+/*
+	Frees the values of every axis.
+*/
+void sweepFree (Sweep sweep) {
+	for (int i = 0; i < sweep->axis_count; i++) {
+		for (int j = 0; j < sweep->axes[i].count; j++) {
+			free(sweep->axes[i].values[j]);
+		}
+		sweep->axes[i].count = 0;
+	}
+	sweep->axis_count = 0;
+}
+
+
+/*
+	Writes the key a run is known by when resuming: its axis values and seed,
+	as they appear at the start of its CSV row.
+*/
+void runKey (Sweep sweep, int cell, unsigned long long seed, char * key, size_t size) {
+	int used = 0;
+	for (int i = 0; i < sweep->axis_count; i++) {
+		SweepAxis axis = &sweep->axes[i];
+		used += snprintf(key + used, size - used, "\"%s\",", axis->values[cell % axis->count]);
+		cell /= axis->count;
+	}
+	snprintf(key + used, size - used, "%llu", seed);
+}
+
+
+int compareKeys (const void * a, const void * b) {
+	return strcmp(*(char * const *) a, *(char * const *) b);
+}
+
+
+/*
+	Reads the runs already in the output file into a sorted list of keys, and cuts
+	off a row left half written by an interrupted sweep. Returns the number of
+	keys, or -1 if the file was written by a sweep with different columns. A key
+	is the first keyFields fields of its row.
+*/
+int loadFinished (const char * path, const char * header, int keyFields, char *** keys) {
+	char * line = NULL;
+	size_t capacity = 0;
+	ssize_t length;
+	long complete = 0;
+	int count = 0, size = 0, fields;
+	FILE * in = fopen(path, "r");
+	*keys = NULL;
+	if (in == NULL) {
+		return 0;
+	}
+	while ((length = getline(&line, &capacity, in)) > 0) {
+		if (line[length - 1] != '\n') {
+			break;
+		}
+		if (complete == 0) {
+			if (strcmp(line, header) != 0) {
+				free(line);
+				fclose(in);
+				return -1;
+			}
+		} else {
+			char * end = line;
+			int quoted = 0;
+			for (fields = 0; *end != '\n'; end++) {
+				if (*end == '"') {
+					quoted = !quoted;
+				} else if (*end == ',' && !quoted && ++fields == keyFields) {
+					break;
+				}
+			}
+			*end = '\0';
+			if (count == size) {
+				size = size ? size * 2 : 256;
+				*keys = realloc(*keys, size * sizeof(char *));
+			}
+			(*keys)[count++] = strdup(line);
+		}
+		complete = ftell(in);
+	}
+	free(line);
+	fclose(in);
+	if (truncate(path, complete) != 0 && complete > 0) {
+		fprintf(stderr, "Could not cut the unfinished row off %s\r\n", path);
+	}
+	qsort(*keys, count, sizeof(char *), compareKeys);
+	return count;
+}
+
+
+/*
+	Appends a finished run to the output as one row and flushes it to disk, so
+	it survives the sweep being killed.
+*/
+void writeRow (SweepTask task, void * arg) {
+	SweepProgress progress = arg;
+	RunResult_s * result = &task->result;
+	char key[SWEEP_SETTINGS_LENGTH];
+	runKey(progress->sweep, task->cell, task->seed, key, sizeof(key));
+	progress->finished++;
+	if (task->status != TASK_DONE) {
+		fprintf(stderr, "[%d/%d] %s failed\r\n", progress->finished, progress->total, key);
+		return;
+	}
+	fprintf(progress->out, "%s,%u,%.4f,%.4f,%.1f,%u,%u,%u,%u,%u,%.4f,%llu,%.4f,%.3f\n", key,
+		task->config.tick_limit ? task->config.tick_limit : SWEEP_DEFAULT_TICKS,
+		result->completed, result->utilization, result->mean_turnaround,
+		result->p50_turnaround, result->p90_turnaround, result->p99_turnaround,
+		result->p99_response, result->p99_response_io, result->context_switches,
+		result->terminated, result->isr_saved, result->mean_io_delay);
+	fflush(progress->out);
+	fsync(fileno(progress->out));
+	printf("[%d/%d] %s p99 turnaround %u completed %.3f\r\n", progress->finished, progress->total,
+		key, result->p99_turnaround, result->completed);
+}
+
+
+/*
+	Runs the sweep in the spec at path, with base as the config every cell starts
+	from, and appends its rows to the sweep's output. Cells whose settings do not
+	fit together (say a demote past the last level) are reported and skipped.
+	Returns 1 if every run succeeded, 0 otherwise.
+*/
+int runSweep (const char * path, SchedConfig base) {
+	Sweep_s sweep;
+	SweepProgress_s progress;
+	SweepTask tasks;
+	char header[SWEEP_SETTINGS_LENGTH] = "";
+	char key[SWEEP_SETTINGS_LENGTH];
+	char * keyPointer = key;
+	char ** finished;
+	int cells = 1, count = 0, skipped = 0, failed, done;
+	FILE * out;
+
+	sweep.base = *base;
+	if (!sweepLoad(&sweep, path)) {
+		sweepFree(&sweep);
+		return 0;
+	}
+	for (int i = 0; i < sweep.axis_count; i++) {
+		cells *= sweep.axes[i].count;
+		strcat(header, sweep.axes[i].key);
+		strcat(header, ",");
+	}
+	strcat(header, "seed,ticks,completed_per_1000,utilization,mean_turnaround,p50_turnaround,"
+		"p90_turnaround,p99_turnaround,p99_response,p99_response_io,context_switches_per_1000,terminated,"
+		"isr_saved_per_1000,mean_io_delay\n");
+	done = loadFinished(sweep.output, header, sweep.axis_count + 1, &finished);
+	if (done < 0) {
+		fprintf(stderr, "%s was written by a sweep with different settings\r\n", sweep.output);
+		sweepFree(&sweep);
+		return 0;
+	}
+
+	tasks = calloc((size_t) cells * sweep.seeds, sizeof(SweepTask_s));
+	for (int cell = 0; cell < cells; cell++) {
+		SchedConfig_s cellConfig = sweep.base;
+		for (int i = 0, rest = cell; i < sweep.axis_count; i++) {
+			SweepAxis axis = &sweep.axes[i];
+			configSet(&cellConfig, axis->key, axis->values[rest % axis->count]);
+			rest /= axis->count;
+		}
+		if (!configFinish(&cellConfig)) {
+			runKey(&sweep, cell, sweep.first_seed, key, sizeof(key));
+			fprintf(stderr, "Skipping cell %s\r\n", key);
+			continue;
+		}
+		for (int s = 0; s < sweep.seeds; s++) {
+			runKey(&sweep, cell, sweep.first_seed + s, key, sizeof(key));
+			if (done > 0 && bsearch(&keyPointer, finished, done, sizeof(char *), compareKeys) != NULL) {
+				skipped++;
+				continue;
+			}
+			tasks[count].config = cellConfig;
+			tasks[count].seed = sweep.first_seed + s;
+			tasks[count].cost = estimateCost(&cellConfig);
+			tasks[count].status = TASK_PENDING;
+			tasks[count].cell = cell;
+			count++;
+		}
+	}
+	for (int i = 0; i < done; i++) {
+		free(finished[i]);
+	}
+	free(finished);
+
+	out = fopen(sweep.output, "a");
+	if (out == NULL) {
+		fprintf(stderr, "Could not open %s\r\n", sweep.output);
+		free(tasks);
+		sweepFree(&sweep);
+		return 0;
+	}
+	fseek(out, 0, SEEK_END);
+	if (ftell(out) == 0) {
+		fputs(header, out);
+		fflush(out);
+	}
+	printf("%d cells, %d runs to go, %d already in %s, %d workers\r\n", cells, count, skipped,
+		sweep.output, sweep.jobs);
+	progress.sweep = &sweep;
+	progress.out = out;
+	progress.finished = 0;
+	progress.total = count;
+	failed = runTasks(tasks, count, sweep.jobs, writeRow, &progress);
+	fclose(out);
+	printf("%d runs done, %d failed\r\n", count - failed, failed);
+	free(tasks);
+	sweepFree(&sweep);
+	return failed == 0;
+}
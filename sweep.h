@@ -0,0 +1,129 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the definitions of structs and declarations of functions for the
+	sweep.c file. A sweep runs the scheduler once for every combination of the
+	values given for each swept setting, across several seeds, in a pool of forked
+	worker processes, and appends one CSV row per run.
+*/
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+//includes
+#include "config.h"
+
+
+//defines
+#define SWEEP_MAX_AXES 8
+#define SWEEP_MAX_VALUES 32
+#define SWEEP_KEY_LENGTH 64
+#define SWEEP_SETTINGS_LENGTH 1024
+#define SWEEP_DEFAULT_SEEDS 4
+#define SWEEP_DEFAULT_TICKS 1000000
+#define SWEEP_FIRST_SEED 1
+#define SWEEP_OUTPUT "sweep.csv"
+#define SWEEP_EVENT_COST 100 // ticks of work an arrival or quantum expiry is worth
+
+
+//enums
+enum task_status {
+	TASK_PENDING,
+	TASK_DONE,
+	TASK_FAILED
+};
+
+
+//structs
+/*
+	What one run of the scheduler measured. Rates are per 1000 ticks and times
+	are in ticks.
+*/
+typedef struct run_result {
+	double completed;
+	double utilization;
+	double mean_turnaround;
+	unsigned int p50_turnaround;
+	unsigned int p90_turnaround;
+	unsigned int p99_turnaround;
+	unsigned int p99_response;
+	unsigned int p99_response_io; // I/O bound PCBs only
+	double context_switches;
+	unsigned long long terminated;
+	double isr_saved; // ISR ticks saved by coalescing I/O interrupts, per 1000 ticks
+	double mean_io_delay; // ticks coalescing added to each I/O wake-up
+} RunResult_s;
+
+/*
+	One run handed to the worker pool. cost is only compared against other
+	tasks' costs, to start the longest runs first.
+*/
+typedef struct sweep_task {
+	SchedConfig_s config;
+	unsigned long long seed;
+	double cost;
+	enum task_status status;
+	RunResult_s result;
+	int cell; // the caller's bookkeeping, runTasks uses neither
+	void * owner;
+} SweepTask_s;
+
+typedef SweepTask_s * SweepTask;
+
+typedef void (* TaskDone) (SweepTask, void *);
+
+typedef struct sweep_axis {
+	char key[SWEEP_KEY_LENGTH];
+	char * values[SWEEP_MAX_VALUES];
+	int count;
+} SweepAxis_s;
+
+typedef SweepAxis_s * SweepAxis;
+
+/*
+	A sweep as loaded from its spec file: the config every cell starts from, the
+	swept settings, and how to run them.
+*/
+typedef struct sweep {
+	SchedConfig_s base;
+	SweepAxis_s axes[SWEEP_MAX_AXES];
+	int axis_count;
+	int seeds;
+	unsigned long long first_seed;
+	int jobs;
+	char output[CONFIG_PATH_LENGTH];
+} Sweep_s;
+
+typedef Sweep_s * Sweep;
+
+typedef struct sweep_progress {
+	Sweep sweep;
+	FILE * out;
+	int finished;
+	int total;
+} SweepProgress_s;
+
+typedef SweepProgress_s * SweepProgress;
+
+
+//declarations
+int runConfig (SchedConfig, unsigned long long, RunResult_s *);
+
+void collectResult (RunResult_s *);
+
+double resultMetric (RunResult_s *, const char *);
+
+double estimateCost (SchedConfig);
+
+int defaultJobs ();
+
+int runTasks (SweepTask, int, int, TaskDone, void *);
+
+int sweepLoad (Sweep, const char *);
+
+void sweepFree (Sweep);
+
+int runSweep (const char *, SchedConfig);
+
+#endif
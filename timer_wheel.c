@@ -0,0 +1,239 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the defined functions declared in the timer_wheel.h header file.
+	A timer at level L always sits in a slot past the wheel's own slot at that
+	level, inside the same slot of the level above. So the first occupied slot
+	after the wheel's, at the lowest level that has one, is always the next
+	thing to happen: a timer going off at level 0, or a slot moving down a
+	level above it. twAdvance jumps from one of those to the next, never tick
+	by tick.
+*/
+
+#include "timer_wheel.h"
+#include <stddef.h>
+
+
+/*
+	Returns the first tick covered by the given slot at the given level, in the
+	same slot of the level above as now.
+*/
+unsigned long long slotStart (unsigned int now, int level, int slot) {
+	unsigned long long above = (unsigned long long) now >> (TW_BITS * (level + 1));
+	return (above << (TW_BITS * (level + 1))) | ((unsigned long long) slot << (TW_BITS * level));
+}
+
+
+/*
+	Appends the node to the list with the given head.
+*/
+void listAppend (TimerNode head, TimerNode node) {
+	node->next = head;
+	node->prev = head->prev;
+	head->prev->next = node;
+	head->prev = node;
+}
+
+
+/*
+	Makes the list with the given head empty.
+*/
+void listClear (TimerNode head) {
+	head->next = head;
+	head->prev = head;
+}
+
+
+/*
+	Puts a linked node into the slot its deadline belongs in, or on the due list
+	if it is due already, and lowers the wheel's next event if it comes sooner.
+*/
+void twPlace (TimerWheel wheel, TimerNode node) {
+	unsigned long long event;
+	if (node->deadline <= wheel->now) {
+		node->level = TW_DUE;
+		listAppend(&wheel->due, node);
+		event = wheel->now;
+	} else {
+		int level = (31 - __builtin_clz(node->deadline ^ wheel->now)) / TW_BITS;
+		node->level = level;
+		node->slot = (node->deadline >> (TW_BITS * level)) & (TW_SLOTS - 1);
+		listAppend(&wheel->slots[level][node->slot], node);
+		wheel->occupied[level] |= 1ULL << node->slot;
+		event = level == 0 ? node->deadline : slotStart(wheel->now, level, node->slot);
+	}
+	if (event < wheel->next) {
+		wheel->next = event;
+	}
+}
+
+
+/*
+	Starts an empty wheel at the given tick.
+*/
+void twInit (TimerWheel wheel, unsigned int now) {
+	wheel->now = now;
+	wheel->next = TW_NEVER;
+	wheel->count = 0;
+	listClear(&wheel->due);
+	for (int level = 0; level < TW_LEVELS; level++) {
+		wheel->occupied[level] = 0;
+		for (int slot = 0; slot < TW_SLOTS; slot++) {
+			listClear(&wheel->slots[level][slot]);
+		}
+	}
+}
+
+
+/*
+	Sets the timer to go off at the given tick, moving it if it was already set.
+	A deadline that has already passed goes off on the next twAdvance.
+*/
+void twAdd (TimerWheel wheel, TimerNode node, unsigned int deadline) {
+	if (node->linked) {
+		twCancel(wheel, node);
+	}
+	node->deadline = deadline;
+	node->linked = 1;
+	node->fired = 0;
+	wheel->count++;
+	twPlace(wheel, node);
+}
+
+
+/*
+	Takes the timer out of the wheel without it going off. Does nothing if it
+	is not set. The wheel's next event is left as it was, which may now be too
+	early, but never too late.
+*/
+void twCancel (TimerWheel wheel, TimerNode node) {
+	if (!node->linked) {
+		return;
+	}
+	node->prev->next = node->next;
+	node->next->prev = node->prev;
+	if (node->level != TW_DUE && wheel->slots[node->level][node->slot].next == &wheel->slots[node->level][node->slot]) {
+		wheel->occupied[node->level] &= ~(1ULL << node->slot);
+	}
+	node->linked = 0;
+	wheel->count--;
+}
+
+
+/*
+	Returns the tick of the next thing the wheel has to do, a timer going off or
+	a slot moving down a level, or TW_NEVER if it is empty.
+*/
+unsigned long long twNextEvent (TimerWheel wheel) {
+	if (wheel->due.next != &wheel->due) {
+		return wheel->now;
+	}
+	for (int level = 0; level < TW_LEVELS; level++) {
+		int own = (wheel->now >> (TW_BITS * level)) & (TW_SLOTS - 1);
+		unsigned long long later = own == TW_SLOTS - 1 ? 0 : wheel->occupied[level] & (~0ULL << (own + 1));
+		if (later != 0) {
+			return slotStart(wheel->now, level, __builtin_ctzll(later));
+		}
+	}
+	return TW_NEVER;
+}
+
+
+/*
+	Returns the tick the next timer goes off at, or TW_NEVER if there is none.
+	Only the slot twNextEvent found is looked through, since every timer in it
+	comes before those in any other.
+*/
+unsigned long long twNextDeadline (TimerWheel wheel) {
+	unsigned long long event = twNextEvent(wheel), soonest = TW_NEVER;
+	TimerNode head;
+	int level;
+	if (event == TW_NEVER || event == wheel->now) {
+		return event;
+	}
+	for (level = 0; level < TW_LEVELS - 1; level++) {
+		if ((event ^ wheel->now) >> (TW_BITS * (level + 1)) == 0) {
+			break;
+		}
+	}
+	if (level == 0) {
+		return event;
+	}
+	head = &wheel->slots[level][(event >> (TW_BITS * level)) & (TW_SLOTS - 1)];
+	for (TimerNode node = head->next; node != head; node = node->next) {
+		if (node->deadline < soonest) {
+			soonest = node->deadline;
+		}
+	}
+	return soonest;
+}
+
+
+/*
+	Unlinks every node on the list with the given head, marks it fired and
+	calls fire on it, if given. The list is taken off its head first, so fire
+	may add timers, even the one it was called for.
+*/
+void twFireList (TimerWheel wheel, TimerNode head, TimerFire fire, void * arg) {
+	TimerNode node = head->next;
+	if (node == head) {
+		return;
+	}
+	head->prev->next = NULL;
+	listClear(head);
+	while (node != NULL) {
+		TimerNode next = node->next;
+		node->linked = 0;
+		node->fired = 1;
+		wheel->count--;
+		if (fire != NULL) {
+			fire(node, arg);
+		}
+		node = next;
+	}
+}
+
+
+/*
+	Moves the wheel's time on to the given tick, and every timer due by then
+	goes off, in order of deadline. Each one is marked fired and given to fire,
+	if not NULL. Moving back in time does nothing.
+*/
+void twAdvance (TimerWheel wheel, unsigned int to, TimerFire fire, void * arg) {
+	while (wheel->next <= to) {
+		unsigned long long event = twNextEvent(wheel);
+		if (event > to) {
+			wheel->next = event;
+			break;
+		}
+		wheel->now = event;
+		twFireList(wheel, &wheel->due, fire, arg);
+
+		// slots whose first tick this is move down, the highest first
+		for (int level = TW_LEVELS - 1; level > 0; level--) {
+			int slot = (wheel->now >> (TW_BITS * level)) & (TW_SLOTS - 1);
+			TimerNode head = &wheel->slots[level][slot];
+			if ((wheel->now & ((1ULL << (TW_BITS * level)) - 1)) == 0 && (wheel->occupied[level] & (1ULL << slot))) {
+				TimerNode node = head->next;
+				head->prev->next = NULL;
+				listClear(head);
+				wheel->occupied[level] &= ~(1ULL << slot);
+				while (node != NULL) {
+					TimerNode next = node->next;
+					twPlace(wheel, node);
+					node = next;
+				}
+			}
+		}
+		if (wheel->occupied[0] & (1ULL << (wheel->now & (TW_SLOTS - 1)))) {
+			wheel->occupied[0] &= ~(1ULL << (wheel->now & (TW_SLOTS - 1)));
+			twFireList(wheel, &wheel->slots[0][wheel->now & (TW_SLOTS - 1)], fire, arg);
+		}
+		twFireList(wheel, &wheel->due, fire, arg);
+		wheel->next = twNextEvent(wheel);
+	}
+	if (to > wheel->now) {
+		wheel->now = to;
+	}
+}
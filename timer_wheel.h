@@ -0,0 +1,69 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the definitions of structs and declarations of functions for the
+	timer_wheel.c file. A hierarchical timing wheel keeps timers that go off at
+	a tick. Each level has TW_SLOTS slots, and a slot at level L covers
+	TW_SLOTS^L ticks, so a timer is put in the level its deadline first differs
+	from the wheel's time at. As time reaches a slot at a higher level, its
+	timers move down a level, until they go off from level 0. Adding and
+	cancelling a timer take constant time, and every timer moves down at most
+	TW_LEVELS times, so going off is constant time too, amortized.
+
+	The wheel never allocates: the caller owns each TimerNode_s, usually inside
+	whatever the timer is for, so it stays cheap with millions of timers.
+*/
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+//defines
+#define TW_BITS 6
+#define TW_SLOTS (1 << TW_BITS) // slots per level, one bit each in the occupied masks
+#define TW_LEVELS 6 // enough for every unsigned int tick
+#define TW_DUE TW_LEVELS // the level of timers that were already due when added
+#define TW_NEVER 0xFFFFFFFFFFFFFFFFULL // the next event of an empty wheel
+
+
+//structs
+typedef struct timer_node {
+	struct timer_node * next;
+	struct timer_node * prev;
+	unsigned int deadline; // tick the timer goes off at
+	unsigned char level; // where it is in the wheel, while linked
+	unsigned char slot;
+	unsigned char linked; // 1 while the timer is waiting to go off
+	unsigned char fired; // set when it goes off, cleared when it is added again
+} TimerNode_s;
+
+typedef TimerNode_s * TimerNode;
+
+typedef void (* TimerFire) (TimerNode, void *);
+
+typedef struct timer_wheel {
+	unsigned int now; // every timer due by this tick has gone off
+	unsigned long long next; // nothing goes off or moves down before this tick
+	unsigned long long occupied[TW_LEVELS]; // which slots of each level hold timers
+	unsigned int count;
+	TimerNode_s due; // the list of timers already due when added
+	TimerNode_s slots[TW_LEVELS][TW_SLOTS]; // the head of each slot's list
+} TimerWheel_s;
+
+typedef TimerWheel_s * TimerWheel;
+
+
+//declarations
+void twInit (TimerWheel, unsigned int);
+
+void twAdd (TimerWheel, TimerNode, unsigned int);
+
+void twCancel (TimerWheel, TimerNode);
+
+unsigned long long twNextEvent (TimerWheel);
+
+unsigned long long twNextDeadline (TimerWheel);
+
+void twAdvance (TimerWheel, unsigned int, TimerFire, void *);
+
+#endif
@@ -0,0 +1,181 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the defined functions declared in the trace_export.h header file.
+	Events are written out as they happen through a buffered FILE, so the trace is
+	never held in memory no matter how long the run is.
+*/
+
+#include "trace_export.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+
+FILE * traceOut = NULL;
+char * traceBuffer = NULL;
+int traceFirstEvent = 1;
+
+int slicePid[TRACE_MAX_CPUS];
+int sliceLevel[TRACE_MAX_CPUS];
+unsigned int sliceStart[TRACE_MAX_CPUS];
+
+int lastQueueLength[NUM_PRIORITIES];
+int lastBlocked;
+
+
+/*
+	Writes the separator that goes before every event but the first.
+*/
+void traceSeparator () {
+	if (traceFirstEvent) {
+		traceFirstEvent = 0;
+	} else {
+		fputs(",\n", traceOut);
+	}
+}
+
+
+/*
+	Opens the given file for the trace and writes the track names. Returns 1 on
+	success, 0 if the file could not be opened.
+*/
+int traceOpen (const char * path) {
+	traceOut = fopen(path, "w");
+	if (traceOut == NULL) {
+		return 0;
+	}
+	traceBuffer = malloc(TRACE_BUFFER_SIZE);
+	if (traceBuffer != NULL) {
+		setvbuf(traceOut, traceBuffer, _IOFBF, TRACE_BUFFER_SIZE);
+	}
+	traceFirstEvent = 1;
+	fputs("[\n", traceOut);
+	traceSeparator();
+	fprintf(traceOut, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"scheduler\"}}");
+	for (int cpu = 0; cpu < TRACE_MAX_CPUS; cpu++) {
+		traceSeparator();
+		fprintf(traceOut, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":\"CPU %d\"}}", cpu, cpu);
+		slicePid[cpu] = TRACE_IDLE_PID;
+		sliceLevel[cpu] = 0;
+		sliceStart[cpu] = 0;
+	}
+	for (int i = 0; i < NUM_PRIORITIES; i++) {
+		lastQueueLength[i] = -1;
+	}
+	lastBlocked = -1;
+	return 1;
+}
+
+
+/*
+	Ends every open running slice at the given tick and closes the trace file.
+*/
+void traceClose (unsigned int tick) {
+	if (traceOut == NULL) {
+		return;
+	}
+	for (int cpu = 0; cpu < TRACE_MAX_CPUS; cpu++) {
+		traceRunning(tick, cpu, TRACE_IDLE_PID, 0);
+	}
+	fputs("\n]\n", traceOut);
+	fclose(traceOut);
+	free(traceBuffer);
+	traceOut = NULL;
+	traceBuffer = NULL;
+}
+
+
+/*
+	Lets go of the trace without ending it, for a forked copy of the simulation
+	that must leave the trace to its parent. The caller flushes the trace before
+	forking, so closing the copy writes nothing.
+*/
+void traceDetach () {
+	if (traceOut == NULL) {
+		return;
+	}
+	fclose(traceOut);
+	free(traceBuffer);
+	traceOut = NULL;
+	traceBuffer = NULL;
+}
+
+
+int traceEnabled () {
+	return traceOut != NULL;
+}
+
+
+/*
+	Notes which PID (TRACE_IDLE_PID for none) is on the given CPU at the given
+	tick. When the PID or its level changes, the slice for the previous one is
+	written out as a complete event, so calling this every tick costs a compare.
+*/
+void traceRunning (unsigned int tick, int cpu, int pid, int level) {
+	if (traceOut == NULL || (pid == slicePid[cpu] && level == sliceLevel[cpu])) {
+		return;
+	}
+	if (slicePid[cpu] != TRACE_IDLE_PID && tick > sliceStart[cpu]) {
+		traceSeparator();
+		fprintf(traceOut, "{\"name\":\"P%d\",\"cat\":\"run\",\"ph\":\"X\",\"ts\":%u,\"dur\":%u,\"pid\":0,\"tid\":%d,\"args\":{\"level\":%d}}",
+			slicePid[cpu], sliceStart[cpu], tick - sliceStart[cpu], cpu, sliceLevel[cpu]);
+	}
+	slicePid[cpu] = pid;
+	sliceLevel[cpu] = level;
+	sliceStart[cpu] = tick;
+}
+
+
+/*
+	Marks something that happened to a PID on the given CPU, such as a demotion
+	or blocking on I/O.
+*/
+void traceInstant (unsigned int tick, int cpu, const char * name, int pid, int level) {
+	if (traceOut == NULL) {
+		return;
+	}
+	traceSeparator();
+	fprintf(traceOut, "{\"name\":\"%s\",\"cat\":\"pcb\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%u,\"pid\":0,\"tid\":%d,\"args\":{\"pid\":%d,\"level\":%d}}",
+		name, tick, cpu, pid, level);
+}
+
+
+/*
+	Marks something that affects the whole scheduler, such as an MLFQ reset.
+*/
+void traceGlobalInstant (unsigned int tick, const char * name) {
+	if (traceOut == NULL) {
+		return;
+	}
+	traceSeparator();
+	fprintf(traceOut, "{\"name\":\"%s\",\"cat\":\"scheduler\",\"ph\":\"i\",\"s\":\"g\",\"ts\":%u,\"pid\":0}", name, tick);
+}
+
+
+/*
+	Updates the counter track for an MLFQ level. Nothing is written unless the
+	length changed since the last call.
+*/
+void traceQueueLength (unsigned int tick, int level, int length) {
+	if (traceOut == NULL || lastQueueLength[level] == length) {
+		return;
+	}
+	lastQueueLength[level] = length;
+	traceSeparator();
+	fprintf(traceOut, "{\"name\":\"MLFQ Q%d\",\"ph\":\"C\",\"ts\":%u,\"pid\":0,\"args\":{\"length\":%d}}", level, tick, length);
+}
+
+
+/*
+	Updates the counter track for the Blocked queue. Nothing is written unless the
+	depth changed since the last call.
+*/
+void traceBlocked (unsigned int tick, int depth) {
+	if (traceOut == NULL || lastBlocked == depth) {
+		return;
+	}
+	lastBlocked = depth;
+	traceSeparator();
+	fprintf(traceOut, "{\"name\":\"Blocked\",\"ph\":\"C\",\"ts\":%u,\"pid\":0,\"args\":{\"depth\":%d}}", tick, depth);
+}
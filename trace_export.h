@@ -0,0 +1,43 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the declarations of functions for the trace_export.c file. It
+	writes a timeline of the simulation in the Chrome trace event format, which
+	chrome://tracing and Perfetto can open directly. One simulated tick is shown as
+	one microsecond.
+*/
+
+#ifndef TRACE_EXPORT_H
+#define TRACE_EXPORT_H
+
+//includes
+#include "pcb.h"
+
+
+//defines
+#define TRACE_MAX_CPUS 1
+#define TRACE_IDLE_PID -1
+#define TRACE_BUFFER_SIZE (1 << 16)
+
+
+//declarations
+int traceOpen (const char *);
+
+void traceClose (unsigned int);
+
+void traceDetach ();
+
+int traceEnabled ();
+
+void traceRunning (unsigned int, int, int, int);
+
+void traceInstant (unsigned int, int, const char *, int, int);
+
+void traceGlobalInstant (unsigned int, const char *);
+
+void traceQueueLength (unsigned int, int, int);
+
+void traceBlocked (unsigned int, int);
+
+#endif
@@ -0,0 +1,479 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the defined functions declared in the tune.h header file. A
+	tuning spec is a config file with extra lines for the search:
+
+		workload = size=pareto,alpha=1.2         # the trace or generator to tune on
+		tune ladder.base = 10 .. 2000 log        # a range to search, "log" draws
+		tune ladder.mult = 1 .. 4                # evenly in the log of the value
+		tune levels = 2 .. 16 int                # and "int" keeps to whole numbers
+		tune reset_count = 5 .. 500 log int
+		tune.objective = p99_response_io         # any sweep column, minimized
+		tune.goal = min                          # or max
+		tune.constraint = completed >= 2.5       # up to TUNE_MAX_CONSTRAINTS
+		tune.candidates = 81
+		tune.eta = 3
+		tune.ticks = 100000                      # first rung's run length
+		tune.seeds = 2
+		tune.seed = 1                            # seeds the configs drawn
+		tune.jobs = 16
+		tune.output = best.cfg                   # loadable with -c
+
+	Every candidate runs on the same seeds, so candidates in a rung see the same
+	arrivals and differ only in their settings.
+*/
+
+#include "tune.h"
+#include "scheduler.h"
+#include <math.h>
+
+
+int rankMaximize; // whether compareCandidates puts the largest objective first
+
+
+/*
+	Reads a "key = low .. high [log] [int]" line into the tuner's ranges. A
+	setting that only takes whole numbers is kept to them without "int". Returns
+	1 on success, 0 otherwise.
+*/
+int parseRange (Tuner tuner, char * line) {
+	SchedConfig_s scratch = tuner->base;
+	char key[SWEEP_KEY_LENGTH], flags[2][8] = {"", ""};
+	double low, high;
+	int read;
+	TuneParam param;
+	char * equals = strchr(line, '=');
+	if (equals == NULL || tuner->param_count >= TUNE_MAX_PARAMS) {
+		return 0;
+	}
+	*equals = '\0';
+	if (strlen(trim(line)) >= SWEEP_KEY_LENGTH) {
+		return 0;
+	}
+	strcpy(key, trim(line));
+	read = sscanf(equals + 1, " %lf .. %lf %7s %7s", &low, &high, flags[0], flags[1]);
+	if (read < 2 || !(low <= high) || *key == '\0') {
+		return 0;
+	}
+	param = &tuner->params[tuner->param_count++];
+	strcpy(param->key, key);
+	param->low = low;
+	param->high = high;
+	param->log = 0;
+	param->integer = !configSet(&scratch, key, "1.5");
+	if (param->integer && !configSet(&scratch, key, "2")) {
+		return 0;
+	}
+	for (int i = 0; i < read - 2; i++) {
+		if (strcmp(flags[i], "log") == 0 && low > 0) {
+			param->log = 1;
+		} else if (strcmp(flags[i], "int") == 0) {
+			param->integer = 1;
+		} else {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+
+/*
+	Reads a "metric >= bound" or "metric <= bound" constraint. Returns 1 on
+	success, 0 otherwise.
+*/
+int parseConstraint (Tuner tuner, const char * value) {
+	RunResult_s probe;
+	char op[3];
+	TuneConstraint constraint;
+	if (tuner->constraint_count >= TUNE_MAX_CONSTRAINTS) {
+		return 0;
+	}
+	constraint = &tuner->constraints[tuner->constraint_count];
+	memset(&probe, 0, sizeof(probe));
+	if (sscanf(value, "%31s %2s %lf", constraint->metric, op, &constraint->bound) != 3
+			|| isnan(resultMetric(&probe, constraint->metric))) {
+		return 0;
+	}
+	if (strcmp(op, ">=") == 0) {
+		constraint->at_least = 1;
+	} else if (strcmp(op, "<=") == 0) {
+		constraint->at_least = 0;
+	} else {
+		return 0;
+	}
+	tuner->constraint_count++;
+	return 1;
+}
+
+
+/*
+	Sets one of the tune.* settings. Returns 1 on success, 0 otherwise.
+*/
+int tuneSet (Tuner tuner, const char * key, const char * value) {
+	RunResult_s probe;
+	char * end;
+	unsigned long long number = strtoull(value, &end, 10);
+	int isCount = (end != value && *end == '\0');
+	memset(&probe, 0, sizeof(probe));
+	if (strcmp(key, "objective") == 0) {
+		if (strlen(value) >= TUNE_METRIC_LENGTH || isnan(resultMetric(&probe, value))) {
+			return 0;
+		}
+		strcpy(tuner->objective, value);
+	} else if (strcmp(key, "goal") == 0 && (strcmp(value, "min") == 0 || strcmp(value, "max") == 0)) {
+		tuner->maximize = strcmp(value, "max") == 0;
+	} else if (strcmp(key, "constraint") == 0) {
+		return parseConstraint(tuner, value);
+	} else if (strcmp(key, "output") == 0 && strlen(value) < CONFIG_PATH_LENGTH) {
+		strcpy(tuner->output, value);
+	} else if (!isCount) {
+		return 0;
+	} else if (strcmp(key, "candidates") == 0 && number >= 1) {
+		tuner->candidates = number;
+	} else if (strcmp(key, "eta") == 0 && number >= 2) {
+		tuner->eta = number;
+	} else if (strcmp(key, "ticks") == 0 && number >= 1) {
+		tuner->ticks = number;
+	} else if (strcmp(key, "seeds") == 0 && number >= 1) {
+		tuner->seeds = number;
+	} else if (strcmp(key, "seed") == 0) {
+		tuner->search_seed = number;
+	} else if (strcmp(key, "jobs") == 0) {
+		tuner->jobs = number ? number : defaultJobs();
+	} else {
+		return 0;
+	}
+	return 1;
+}
+
+
+/*
+	Loads the tuning spec at path, on top of the config already in tuner->base.
+	Returns 1 on success, 0 if the file could not be read, has a bad line (which
+	is reported with its line number) or has nothing to tune.
+*/
+int tunerLoad (Tuner tuner, const char * path) {
+	char line[CONFIG_MAX_LINE];
+	char * comment, * setting, * value;
+	int lineNumber = 0, ok = 1;
+	FILE * in = fopen(path, "r");
+	if (in == NULL) {
+		fprintf(stderr, "Could not open tuning spec %s\r\n", path);
+		return 0;
+	}
+	tuner->param_count = 0;
+	tuner->constraint_count = 0;
+	strcpy(tuner->objective, "p99_response");
+	tuner->maximize = 0;
+	tuner->candidates = TUNE_CANDIDATES;
+	tuner->eta = TUNE_ETA;
+	tuner->ticks = TUNE_TICKS;
+	tuner->seeds = TUNE_SEEDS;
+	tuner->first_seed = SWEEP_FIRST_SEED;
+	tuner->search_seed = TUNE_SEED;
+	tuner->jobs = defaultJobs();
+	tuner->output[0] = '\0';
+	while (ok && fgets(line, sizeof(line), in) != NULL) {
+		lineNumber++;
+		comment = strchr(line, '#');
+		if (comment != NULL) {
+			*comment = '\0';
+		}
+		setting = trim(line);
+		if (*setting == '\0') {
+			continue;
+		}
+		if (strncmp(setting, "tune ", 5) == 0) {
+			ok = parseRange(tuner, setting + 5);
+		} else if (strncmp(setting, "tune.", 5) == 0 && (value = strchr(setting, '=')) != NULL) {
+			*value++ = '\0';
+			ok = tuneSet(tuner, trim(setting + 5), trim(value));
+		} else {
+			ok = configSetPair(&tuner->base, setting);
+		}
+		if (!ok) {
+			fprintf(stderr, "%s:%d: bad setting \"%s\"\r\n", path, lineNumber, setting);
+		}
+	}
+	fclose(in);
+	if (ok && tuner->param_count == 0) {
+		fprintf(stderr, "%s has no \"tune\" ranges\r\n", path);
+		ok = 0;
+	}
+	return ok;
+}
+
+
+/*
+	Builds the candidate's config from the base and its values. Returns 1 if the
+	settings fit together, 0 otherwise.
+*/
+int buildConfig (Tuner tuner, Candidate candidate) {
+	char value[64];
+	candidate->config = tuner->base;
+	for (int i = 0; i < tuner->param_count; i++) {
+		snprintf(value, sizeof(value), tuner->params[i].integer ? "%.0f" : "%g", candidate->values[i]);
+		if (!configSet(&candidate->config, tuner->params[i].key, value)) {
+			return 0;
+		}
+	}
+	return configFinish(&candidate->config);
+}
+
+
+/*
+	Keeps a value inside its range, rounded if the setting is a whole number.
+*/
+double clampValue (TuneParam param, double value) {
+	if (param->integer) {
+		value = round(value);
+	}
+	if (value < param->low) {
+		value = param->integer ? ceil(param->low) : param->low;
+	}
+	if (value > param->high) {
+		value = param->integer ? floor(param->high) : param->high;
+	}
+	return value;
+}
+
+
+/*
+	Draws a random candidate from the ranges, redrawing up to TUNE_RESAMPLE times
+	if the settings do not fit together. Returns 1 on success, 0 otherwise.
+*/
+int makeCandidate (Tuner tuner, Candidate candidate) {
+	memset(candidate, 0, sizeof(Candidate_s));
+	for (int attempt = 0; attempt < TUNE_RESAMPLE; attempt++) {
+		for (int i = 0; i < tuner->param_count; i++) {
+			TuneParam param = &tuner->params[i];
+			double u = rngUniform();
+			double value;
+			if (param->log) {
+				value = exp(log(param->low) + u * (log(param->high) - log(param->low)));
+			} else if (param->integer) {
+				// widen by half a step either side so the end values are as likely as the rest
+				value = (param->low - 0.5) + u * (param->high - param->low + 1.0);
+			} else {
+				value = param->low + u * (param->high - param->low);
+			}
+			candidate->values[i] = clampValue(param, value);
+		}
+		if (buildConfig(tuner, candidate)) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+
+/*
+	Adds a finished run to its candidate's sums.
+*/
+void addRun (SweepTask task, void * arg) {
+	Tuner tuner = arg;
+	Candidate candidate = (Candidate) task->owner;
+	if (task->status != TASK_DONE) {
+		candidate->failed = 1;
+		return;
+	}
+	candidate->objective += resultMetric(&task->result, tuner->objective);
+	for (int i = 0; i < tuner->constraint_count; i++) {
+		candidate->constraint_sums[i] += resultMetric(&task->result, tuner->constraints[i].metric);
+	}
+	candidate->runs++;
+}
+
+
+/*
+	Runs every candidate on every seed for the given number of ticks, in parallel,
+	and sets each candidate's objective and violation to the average over the
+	seeds. A candidate with a failed run is treated as missing every constraint.
+*/
+void evaluateCandidates (Tuner tuner, Candidate candidates, int count, unsigned int ticks) {
+	SweepTask tasks = calloc((size_t) count * tuner->seeds, sizeof(SweepTask_s));
+	int taskCount = 0;
+	for (int i = 0; i < count; i++) {
+		Candidate candidate = &candidates[i];
+		candidate->objective = 0;
+		candidate->runs = 0;
+		candidate->failed = 0;
+		memset(candidate->constraint_sums, 0, sizeof(candidate->constraint_sums));
+		candidate->config.tick_limit = ticks;
+		for (int s = 0; s < tuner->seeds; s++) {
+			tasks[taskCount].config = candidate->config;
+			tasks[taskCount].seed = tuner->first_seed + s;
+			tasks[taskCount].cost = estimateCost(&candidate->config);
+			tasks[taskCount].status = TASK_PENDING;
+			tasks[taskCount].owner = candidate;
+			taskCount++;
+		}
+	}
+	runTasks(tasks, taskCount, tuner->jobs, addRun, tuner);
+	free(tasks);
+
+	for (int i = 0; i < count; i++) {
+		Candidate candidate = &candidates[i];
+		if (candidate->failed || candidate->runs == 0) {
+			candidate->objective = NAN;
+			candidate->violation = INFINITY;
+			continue;
+		}
+		candidate->objective /= candidate->runs;
+		candidate->violation = 0;
+		for (int c = 0; c < tuner->constraint_count; c++) {
+			TuneConstraint constraint = &tuner->constraints[c];
+			double mean = candidate->constraint_sums[c] / candidate->runs;
+			double miss = constraint->at_least ? constraint->bound - mean : mean - constraint->bound;
+			if (miss > 0) {
+				candidate->violation += miss / (fabs(constraint->bound) > 0 ? fabs(constraint->bound) : 1.0);
+			}
+		}
+	}
+}
+
+
+/*
+	Orders candidates best first, for qsort: candidates meeting every constraint
+	by objective, then the rest by how far they miss.
+*/
+int compareCandidates (const void * a, const void * b) {
+	const Candidate_s * first = a;
+	const Candidate_s * second = b;
+	if (first->violation != second->violation) {
+		return first->violation < second->violation ? -1 : 1;
+	}
+	if (first->objective == second->objective) {
+		return 0;
+	}
+	return (first->objective < second->objective) != rankMaximize ? -1 : 1;
+}
+
+
+/*
+	Prints the candidate's tuned settings as config lines.
+*/
+void printCandidate (Tuner tuner, Candidate candidate, FILE * out, const char * prefix) {
+	for (int i = 0; i < tuner->param_count; i++) {
+		fprintf(out, tuner->params[i].integer ? "%s%s = %.0f\n" : "%s%s = %g\n",
+			prefix, tuner->params[i].key, candidate->values[i]);
+	}
+}
+
+
+/*
+	Reruns the best candidate with each setting moved one step down and one step
+	up (a factor of TUNE_LOG_STEP for log ranges, TUNE_LINEAR_STEP of the range
+	otherwise, at least 1 for whole numbers) and prints how far the objective
+	moves, so a flat optimum can be told apart from a knife edge.
+*/
+void reportSensitivity (Tuner tuner, Candidate best, unsigned int ticks) {
+	Candidate neighbours = calloc(2 * tuner->param_count, sizeof(Candidate_s));
+	int count = 0;
+	for (int i = 0; i < tuner->param_count; i++) {
+		TuneParam param = &tuner->params[i];
+		for (int direction = -1; direction <= 1; direction += 2) {
+			Candidate neighbour = &neighbours[count];
+			double step = param->log ? 0 : TUNE_LINEAR_STEP * (param->high - param->low);
+			double value;
+			if (param->integer && step < 1) {
+				step = 1;
+			}
+			value = param->log ? best->values[i] * pow(TUNE_LOG_STEP, direction) : best->values[i] + direction * step;
+			*neighbour = *best;
+			neighbour->values[i] = clampValue(param, value);
+			if (neighbour->values[i] != best->values[i] && buildConfig(tuner, neighbour)) {
+				count++;
+			}
+		}
+	}
+	evaluateCandidates(tuner, neighbours, count, ticks);
+
+	printf("Sensitivity of %s around the best config:\r\n", tuner->objective);
+	for (int n = 0; n < count; n++) {
+		for (int i = 0; i < tuner->param_count; i++) {
+			if (neighbours[n].values[i] == best->values[i]) {
+				continue;
+			}
+			printf("  %-20s %12g -> %12g  %s %12.1f (%+6.1f%%)%s\r\n", tuner->params[i].key,
+				best->values[i], neighbours[n].values[i], tuner->objective, neighbours[n].objective,
+				100.0 * (neighbours[n].objective - best->objective) / best->objective,
+				neighbours[n].violation > 0 ? "  misses a constraint" : "");
+		}
+	}
+	free(neighbours);
+}
+
+
+/*
+	Runs the tuner in the spec at path, with base as the config every candidate
+	starts from. Each rung runs its candidates for eta times as long as the rung
+	before and keeps the best 1 / eta of them, until one is left; the winner is
+	printed, written to the spec's output if one was given, and its sensitivity
+	reported. Returns 1 if a config meeting the constraints was found, 0
+	otherwise.
+*/
+int runTuner (const char * path, SchedConfig base) {
+	Tuner_s tuner;
+	Candidate candidates;
+	unsigned int ticks;
+	int count = 0, rung = 0;
+
+	tuner.base = *base;
+	if (!tunerLoad(&tuner, path)) {
+		return 0;
+	}
+	rankMaximize = tuner.maximize;
+	rngSeed(tuner.search_seed);
+	candidates = calloc(tuner.candidates, sizeof(Candidate_s));
+	for (int i = 0; i < tuner.candidates; i++) {
+		if (makeCandidate(&tuner, &candidates[count])) {
+			count++;
+		}
+	}
+	if (count == 0) {
+		fprintf(stderr, "No config drawn from the ranges has settings that fit together\r\n");
+		free(candidates);
+		return 0;
+	}
+
+	for (ticks = tuner.ticks; ; ticks *= tuner.eta, rung++) {
+		evaluateCandidates(&tuner, candidates, count, ticks);
+		qsort(candidates, count, sizeof(Candidate_s), compareCandidates);
+		printf("Rung %d: %d configs for %u ticks, best %s %.1f%s\r\n", rung, count, ticks,
+			tuner.objective, candidates[0].objective,
+			candidates[0].violation > 0 ? " (misses a constraint)" : "");
+		if (count == 1) {
+			break;
+		}
+		count = (count + tuner.eta - 1) / tuner.eta;
+	}
+
+	printf("Best config, %s %.1f:\r\n", tuner.objective, candidates[0].objective);
+	printCandidate(&tuner, &candidates[0], stdout, "  ");
+	if (candidates[0].violation > 0) {
+		printf("No config met every constraint, this one came closest\r\n");
+	}
+	if (tuner.output[0]) {
+		FILE * out = fopen(tuner.output, "w");
+		if (out == NULL) {
+			fprintf(stderr, "Could not open %s\r\n", tuner.output);
+		} else {
+			// the whole config, so the base settings it was measured with come along
+			SchedConfig_s best = candidates[0].config;
+			best.tick_limit = tuner.base.tick_limit; // not the last rung's
+			fprintf(out, "# tuned for %s %s, %.1f over %d seeds of %u ticks, with\n",
+				tuner.maximize ? "max" : "min", tuner.objective, candidates[0].objective, tuner.seeds, ticks);
+			printCandidate(&tuner, &candidates[0], out, "# ");
+			configPrint(&best, out);
+			fclose(out);
+		}
+	}
+	reportSensitivity(&tuner, &candidates[0], ticks);
+
+	count = candidates[0].violation == 0;
+	free(candidates);
+	return count;
+}
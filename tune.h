@@ -0,0 +1,102 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the definitions of structs and declarations of functions for the
+	tune.c file. The tuner searches ranges of settings for the config that does
+	best on an objective, subject to constraints, using successive halving: many
+	random configs get a short run, the best share of them a longer one, and so on
+	until one is left. It then reports how the objective moves as each setting is
+	nudged away from the best value.
+*/
+
+#ifndef TUNE_H
+#define TUNE_H
+
+//includes
+#include "sweep.h"
+
+
+//defines
+#define TUNE_MAX_PARAMS 8
+#define TUNE_MAX_CONSTRAINTS 4
+#define TUNE_METRIC_LENGTH 32
+#define TUNE_CANDIDATES 64
+#define TUNE_ETA 3 // each rung keeps 1 / TUNE_ETA of the candidates and runs them TUNE_ETA times longer
+#define TUNE_TICKS 100000 // ticks each candidate runs for in the first rung
+#define TUNE_SEEDS 2
+#define TUNE_SEED 1
+#define TUNE_RESAMPLE 100 // tries to draw a config whose settings fit together
+#define TUNE_LOG_STEP 2.0 // sensitivity steps a log setting by this factor either way
+#define TUNE_LINEAR_STEP 0.1 // and any other setting by this share of its range
+
+
+//structs
+typedef struct tune_param {
+	char key[SWEEP_KEY_LENGTH];
+	double low;
+	double high;
+	int log; // drawn uniformly in the log of the value
+	int integer;
+} TuneParam_s;
+
+typedef TuneParam_s * TuneParam;
+
+typedef struct tune_constraint {
+	char metric[TUNE_METRIC_LENGTH];
+	int at_least; // 1 for >=, 0 for <=
+	double bound;
+} TuneConstraint_s;
+
+typedef TuneConstraint_s * TuneConstraint;
+
+typedef struct tuner {
+	SchedConfig_s base;
+	TuneParam_s params[TUNE_MAX_PARAMS];
+	int param_count;
+	TuneConstraint_s constraints[TUNE_MAX_CONSTRAINTS];
+	int constraint_count;
+	char objective[TUNE_METRIC_LENGTH];
+	int maximize;
+	int candidates;
+	int eta;
+	unsigned int ticks;
+	int seeds;
+	unsigned long long first_seed; // seeds the runs, the same for every candidate
+	unsigned long long search_seed; // seeds the configs drawn
+	int jobs;
+	char output[CONFIG_PATH_LENGTH]; // the best config is written here when set
+} Tuner_s;
+
+typedef Tuner_s * Tuner;
+
+/*
+	One config being tried, with its measurements averaged over the seeds of its
+	latest run. violation is 0 when every constraint is met and grows with how
+	far they are missed.
+*/
+typedef struct candidate {
+	double values[TUNE_MAX_PARAMS];
+	SchedConfig_s config;
+	double objective;
+	double constraint_sums[TUNE_MAX_CONSTRAINTS];
+	double violation;
+	int runs;
+	int failed;
+} Candidate_s;
+
+typedef Candidate_s * Candidate;
+
+
+//declarations
+int tunerLoad (Tuner, const char *);
+
+int makeCandidate (Tuner, Candidate);
+
+void evaluateCandidates (Tuner, Candidate, int, unsigned int);
+
+int compareCandidates (const void *, const void *);
+
+int runTuner (const char *, SchedConfig);
+
+#endif
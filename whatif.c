@@ -0,0 +1,185 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the defined functions declared in the whatif.h header file.
+	The copies are made with fork(), so every queue, PCB, timer and the RNG come
+	along as they are, and the kernel only copies the pages a branch goes on to
+	change. Each branch pays for the ticks after the fork and nothing before it.
+
+		scheduler -g rate=0.003 -f 500000 -F reset_count=60 -F "levels=4;ladder.base=200"
+
+	The totals every branch reports, the baseline's included, start at the fork.
+*/
+
+#include "whatif.h"
+#include "scheduler.h"
+#include <sys/wait.h>
+
+
+WhatIf_s whatIf = {.branch = -1};
+
+
+/*
+	Adds a branch with the given settings. Returns 1 on success, 0 if there are
+	already WHATIF_MAX_BRANCHES.
+*/
+int whatIfAdd (const char * settings) {
+	if (whatIf.count >= WHATIF_MAX_BRANCHES) {
+		return 0;
+	}
+	whatIf.settings[whatIf.count++] = settings;
+	return 1;
+}
+
+
+/*
+	Applies the ';' separated settings on top of cfg, which should not be
+	finished yet, and finishes it. The arrival source can not be swapped mid-run,
+	and the queues a branch inherits are already built, so "workload" and
+	"queue" are refused. Returns 1 if the settings are valid and fit
+	together, 0 otherwise.
+*/
+int branchConfig (SchedConfig cfg, const char * settings) {
+	char buffer[CONFIG_MAX_LINE];
+	char * setting, * rest;
+	if (strlen(settings) >= sizeof(buffer)) {
+		return 0;
+	}
+	strcpy(buffer, settings);
+	for (setting = strtok_r(buffer, ";", &rest); setting != NULL; setting = strtok_r(NULL, ";", &rest)) {
+		setting = trim(setting);
+		if (strncmp(setting, "workload", 8) == 0 || strncmp(setting, "queue", 5) == 0 || !configSetPair(cfg, setting)) {
+			fprintf(stderr, "Bad branch setting \"%s\"\r\n", setting);
+			return 0;
+		}
+	}
+	return configFinish(cfg);
+}
+
+
+/*
+	Switches this copy of the simulation over to the given branch's settings.
+	The generator keeps its place in time, only its parameters change.
+*/
+void enterBranch (Scheduler theScheduler, int branch) {
+	SchedConfig_s branched = baseConfig;
+	Generator_s running = config.generator;
+	whatIf.branch = branch;
+	if (branch == 0) {
+		return;
+	}
+	branchConfig(&branched, whatIf.settings[branch - 1]);
+	branched.generator.mmpp_state = running.mmpp_state;
+	branched.generator.state_end = running.state_end;
+	branched.generator.next_time = running.next_time;
+	branched.tick_limit = config.tick_limit;
+	config = branched;
+	configureScheduler(theScheduler);
+
+	// the files belong to the baseline
+	logEnabled = 0;
+	metricsPath = NULL;
+	checkpointPath = NULL;
+	traceDetach();
+	flameDetach();
+	if (recorder != NULL) {
+		recorderDetach(recorder);
+		recorder = NULL;
+	}
+}
+
+
+/*
+	Forks a copy of the simulation for every branch and moves each copy onto its
+	branch's settings; this process carries on as the baseline. Totals are
+	restarted in every copy so they only cover the ticks after the fork. A
+	branch that can not be forked is reported and left out.
+*/
+void whatIfFork (Scheduler theScheduler) {
+	int branch = 0;
+	latencyReset();
+	memset(&runStats, 0, sizeof(runStats));
+	runStats.start_tick = sim_tick;
+	switchCalls = 0;
+	fflush(NULL);
+	for (int i = 0; i < whatIf.count; i++) {
+		int fd[2];
+		whatIf.pids[i] = -1;
+		if (pipe(fd) != 0) {
+			fprintf(stderr, "Could not fork branch %d\r\n", i + 1);
+			continue;
+		}
+		whatIf.pids[i] = fork();
+		if (whatIf.pids[i] == 0) {
+			close(fd[0]);
+			for (int j = 0; j < i; j++) {
+				if (whatIf.pids[j] > 0) {
+					close(whatIf.pipes[j]);
+				}
+			}
+			whatIf.pipes[i] = fd[1];
+			branch = i + 1;
+			break;
+		}
+		close(fd[1]);
+		if (whatIf.pids[i] < 0) {
+			close(fd[0]);
+			fprintf(stderr, "Could not fork branch %d\r\n", i + 1);
+			continue;
+		}
+		whatIf.pipes[i] = fd[0];
+	}
+	enterBranch(theScheduler, branch);
+}
+
+
+/*
+	Prints one row of the comparison.
+*/
+void printBranch (int branch, const char * settings, RunResult_s * result) {
+	printf("%-6d %-36s %9.3f %6.3f %10.1f %8u %8u %8u %8.2f\r\n", branch, settings,
+		result->completed, result->utilization, result->mean_turnaround, result->p99_turnaround,
+		result->p99_response, result->p99_response_io, result->context_switches);
+}
+
+
+/*
+	Called once osLoop returns. A branch sends its results to the baseline and
+	exits; the baseline waits for every branch and prints them all side by side.
+	Does nothing if the run never reached the fork.
+*/
+void whatIfFinish () {
+	RunResult_s result;
+	if (whatIf.branch < 0) {
+		if (whatIf.count > 0) {
+			fprintf(stderr, "The run ended before tick %u, nothing was branched\r\n", whatIf.at);
+		}
+		return;
+	}
+	collectResult(&result);
+	if (whatIf.branch > 0) {
+		int ok = write(whatIf.pipes[whatIf.branch - 1], &result, sizeof(result)) == sizeof(result);
+		_exit(ok ? 0 : 1);
+	}
+
+	printf("What-if branches from tick %u to tick %u:\r\n", whatIf.at, sim_tick);
+	printf("%-6s %-36s %9s %6s %10s %8s %8s %8s %8s\r\n", "branch", "settings", "completed",
+		"util", "mean_turn", "p99_turn", "p99_resp", "p99_io", "switches");
+	printBranch(0, "(baseline)", &result);
+	for (int i = 0; i < whatIf.count; i++) {
+		RunResult_s branched;
+		int status = 1;
+		if (whatIf.pids[i] < 0) {
+			continue;
+		}
+		if (waitpid(whatIf.pids[i], &status, 0) == whatIf.pids[i] && WIFEXITED(status)
+				&& WEXITSTATUS(status) == 0
+				&& read(whatIf.pipes[i], &branched, sizeof(branched)) == sizeof(branched)) {
+			printBranch(i + 1, whatIf.settings[i], &branched);
+		} else {
+			printf("%-6d %-36s failed\r\n", i + 1, whatIf.settings[i]);
+		}
+		close(whatIf.pipes[i]);
+	}
+}
@@ -0,0 +1,47 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the definitions of structs and declarations of functions for the
+	whatif.c file. A what-if run simulates up to a given tick once, then forks a
+	copy of the whole simulation for each branch, which goes on under its own
+	settings while the original carries on unchanged as the baseline.
+*/
+
+#ifndef WHATIF_H
+#define WHATIF_H
+
+//includes
+#include "config.h"
+#include <sys/types.h>
+
+
+//defines
+#define WHATIF_MAX_BRANCHES 16
+
+
+//structs
+struct scheduler; // scheduler.h includes this file
+
+typedef struct what_if {
+	unsigned int at; // tick the branches fork at
+	int count; // branches besides the baseline
+	const char * settings[WHATIF_MAX_BRANCHES]; // "key=value;key=value" for each branch
+	int branch; // -1 before the fork, 0 in the baseline, 1 to count in a branch
+	pid_t pids[WHATIF_MAX_BRANCHES];
+	int pipes[WHATIF_MAX_BRANCHES];
+} WhatIf_s;
+
+
+//declarations
+extern WhatIf_s whatIf;
+
+int whatIfAdd (const char *);
+
+int branchConfig (SchedConfig, const char *);
+
+void whatIfFork (struct scheduler *);
+
+void whatIfFinish ();
+
+#endif
@@ -0,0 +1,217 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the defined functions declared in the workload.h header file.
+	Replay maps the workload file instead of reading it, so the kernel only pages in
+	the records near the current arrival, and pages already replayed are handed back
+	as the replay moves on. Even a very large trace only ever has a small window in
+	memory.
+*/
+
+#include "workload.h"
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+/*
+	Maps the given workload file and checks its header. Returns NULL if the file
+	can not be opened or is not a workload file.
+*/
+Workload workloadOpen (const char * path) {
+	struct stat info;
+	WorkloadHeader_s * header;
+	unsigned long long available;
+	Workload workload = malloc(sizeof(Workload_s));
+	if (workload == NULL) {
+		return NULL;
+	}
+	workload->fd = open(path, O_RDONLY);
+	if (workload->fd < 0 || fstat(workload->fd, &info) != 0 || info.st_size < (off_t) sizeof(WorkloadHeader_s)) {
+		if (workload->fd >= 0) {
+			close(workload->fd);
+		}
+		free(workload);
+		return NULL;
+	}
+	workload->map_size = info.st_size;
+	workload->map = mmap(NULL, workload->map_size, PROT_READ, MAP_PRIVATE, workload->fd, 0);
+	if (workload->map == MAP_FAILED) {
+		close(workload->fd);
+		free(workload);
+		return NULL;
+	}
+	madvise(workload->map, workload->map_size, MADV_SEQUENTIAL);
+
+	header = (WorkloadHeader_s *) workload->map;
+	if (header->magic != WORKLOAD_MAGIC || header->version != WORKLOAD_VERSION
+			|| header->record_size != sizeof(WorkloadRecord_s)) {
+		workloadClose(workload);
+		return NULL;
+	}
+	available = (workload->map_size - sizeof(WorkloadHeader_s)) / sizeof(WorkloadRecord_s);
+	workload->count = header->count;
+	if (workload->count == 0 || workload->count > available) {
+		workload->count = available;
+	}
+	workload->records = (WorkloadRecord_s *) (workload->map + sizeof(WorkloadHeader_s));
+	workload->next = 0;
+	workload->released = 0;
+	workload->flags = header->flags;
+	return workload;
+}
+
+
+/*
+	Unmaps and closes the given workload.
+*/
+void workloadClose (Workload workload) {
+	munmap(workload->map, workload->map_size);
+	close(workload->fd);
+	free(workload);
+}
+
+
+/*
+	Returns 1 once every arrival in the workload has been handed out.
+*/
+int workloadDone (Workload workload) {
+	return workload->next >= workload->count;
+}
+
+
+/*
+	Returns the tick of the next arrival, or -1 if there are none left.
+*/
+unsigned int workloadNextArrival (Workload workload) {
+	if (workloadDone(workload)) {
+		return -1;
+	}
+	return workload->records[workload->next].arrival;
+}
+
+
+/*
+	Moves the replay to the given record, as when resuming a checkpointed run.
+*/
+void workloadSeek (Workload workload, unsigned long long next) {
+	workload->next = next < workload->count ? next : workload->count;
+}
+
+
+/*
+	Gives the pages in front of the next record back to the kernel once enough of
+	them have been replayed.
+*/
+void releaseReplayed (Workload workload) {
+	long pageSize = sysconf(_SC_PAGESIZE);
+	unsigned long long consumed = sizeof(WorkloadHeader_s) + workload->next * sizeof(WorkloadRecord_s);
+	consumed -= consumed % pageSize;
+	if (consumed - workload->released >= WORKLOAD_RELEASE_BYTES) {
+		madvise(workload->map + workload->released, consumed - workload->released, MADV_DONTNEED);
+		workload->released = consumed;
+	}
+}
+
+
+/*
+	If the next arrival is due at or before the given tick, creates its PCB and
+	returns it. Returns NULL if nothing is due yet. Call it until it returns NULL
+	to get every PCB due this tick.
+*/
+PCB workloadNext (Workload workload, unsigned int tick) {
+	WorkloadRecord_s * record;
+	PCB pcb;
+	if (workloadDone(workload) || workload->records[workload->next].arrival > tick) {
+		return NULL;
+	}
+	pcb = PCB_create_blank(); // a replay draws nothing from the RNG for its arrivals
+	if (pcb == NULL) {
+		return NULL;
+	}
+	record = &workload->records[workload->next];
+	pcb->max_pc = record->max_pc;
+	pcb->terminate = record->terminate;
+	memcpy(pcb->io_1_traps, record->io_1_traps, sizeof(pcb->io_1_traps));
+	memcpy(pcb->io_2_traps, record->io_2_traps, sizeof(pcb->io_2_traps));
+	pcb->channel_no = record->channel_no;
+	PCB_assign_priority(pcb, record->priority);
+	workload->next++;
+	releaseReplayed(workload);
+	return pcb;
+}
+
+
+/*
+	Opens a workload file for recording and writes a placeholder header, which is
+	filled in by recorderClose. Returns NULL if the file can not be opened.
+*/
+WorkloadRecorder recorderOpen (const char * path) {
+	WorkloadHeader_s header = {WORKLOAD_MAGIC, WORKLOAD_VERSION, sizeof(WorkloadRecord_s), 0, 0};
+	WorkloadRecorder recorder = malloc(sizeof(WorkloadRecorder_s));
+	if (recorder == NULL) {
+		return NULL;
+	}
+	recorder->out = fopen(path, "wb");
+	if (recorder->out == NULL || fwrite(&header, sizeof(header), 1, recorder->out) != 1) {
+		if (recorder->out != NULL) {
+			fclose(recorder->out);
+		}
+		free(recorder);
+		return NULL;
+	}
+	recorder->count = 0;
+	recorder->flags = 0;
+	return recorder;
+}
+
+
+/*
+	Appends the given PCB as an arrival at the given tick. Returns 1 on success,
+	0 otherwise.
+*/
+int recorderWrite (WorkloadRecorder recorder, PCB pcb, unsigned int tick) {
+	WorkloadRecord_s record;
+	memset(&record, 0, sizeof(record));
+	record.arrival = tick;
+	record.max_pc = pcb->max_pc;
+	record.terminate = pcb->terminate;
+	memcpy(record.io_1_traps, pcb->io_1_traps, sizeof(record.io_1_traps));
+	memcpy(record.io_2_traps, pcb->io_2_traps, sizeof(record.io_2_traps));
+	record.channel_no = pcb->channel_no;
+	record.priority = pcb->priority;
+	if (fwrite(&record, sizeof(record), 1, recorder->out) != 1) {
+		return 0;
+	}
+	recorder->count++;
+	return 1;
+}
+
+
+/*
+	Writes the final record count and the flags into the header and closes the
+	recording.
+*/
+void recorderClose (WorkloadRecorder recorder) {
+	WorkloadHeader_s header = {WORKLOAD_MAGIC, WORKLOAD_VERSION, sizeof(WorkloadRecord_s), recorder->flags, recorder->count};
+	if (fseek(recorder->out, 0, SEEK_SET) == 0) {
+		fwrite(&header, sizeof(header), 1, recorder->out);
+	}
+	fclose(recorder->out);
+	free(recorder);
+}
+
+
+/*
+	Closes the recording without writing its header, for a forked copy of the
+	simulation that must leave the recording to its parent. The caller flushes
+	the recording before forking.
+*/
+void recorderDetach (WorkloadRecorder recorder) {
+	fclose(recorder->out);
+	free(recorder);
+}
@@ -0,0 +1,95 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the definitions of structs and declarations of functions for the
+	workload.c file. A workload file is a header followed by one fixed size record
+	per arrival, sorted by arrival tick. Records are written in the host's byte order.
+	A recording of a run without a generator has WORKLOAD_AT_RESETS set, and its
+	replay admits each arrival at the MLFQ reset it was made at, where the run
+	made it, instead of at the start of its tick. A recording of a run stopped at
+	its tick limit has WORKLOAD_CUT_SHORT set, and its replay runs to its own
+	tick limit rather than end once its arrivals are done.
+*/
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+//includes
+#include "pcb.h"
+#include <stdio.h>
+
+
+//defines
+#define WORKLOAD_MAGIC 0x4B4C5751
+#define WORKLOAD_VERSION 1
+#define WORKLOAD_RELEASE_BYTES (1 << 20)
+#define WORKLOAD_AT_RESETS 0x1 // the arrivals were made at MLFQ resets, not streamed
+#define WORKLOAD_CUT_SHORT 0x2 // the run was stopped at its tick limit, not by its arrivals
+
+
+//structs
+typedef struct workload_header {
+	unsigned int magic;
+	unsigned int version;
+	unsigned int record_size;
+	unsigned int flags; // WORKLOAD_AT_RESETS and WORKLOAD_CUT_SHORT, 0 in files from before them
+	unsigned long long count; // number of records, 0 if the recorder never closed
+} WorkloadHeader_s;
+
+typedef struct workload_record {
+	unsigned int arrival; // tick the PCB arrives in the created queue
+	unsigned int max_pc;
+	unsigned int terminate;
+	unsigned int io_1_traps[TRAP_COUNT];
+	unsigned int io_2_traps[TRAP_COUNT];
+	unsigned char channel_no; // which I/O device the PCB uses
+	unsigned char priority; // starting priority
+	unsigned char pad[2];
+} WorkloadRecord_s;
+
+/* A workload file mapped into memory, with the position of the next arrival. */
+typedef struct workload {
+	int fd;
+	unsigned char * map;
+	unsigned long long map_size;
+	WorkloadRecord_s * records;
+	unsigned long long count;
+	unsigned long long next;
+	unsigned long long released; // bytes at the front of the map already given back
+	unsigned int flags;
+} Workload_s;
+
+typedef Workload_s * Workload;
+
+typedef struct workload_recorder {
+	FILE * out;
+	unsigned long long count;
+	unsigned int flags; // written to the header by recorderClose
+} WorkloadRecorder_s;
+
+typedef WorkloadRecorder_s * WorkloadRecorder;
+
+
+//declarations
+Workload workloadOpen (const char *);
+
+void workloadClose (Workload);
+
+int workloadDone (Workload);
+
+unsigned int workloadNextArrival (Workload);
+
+PCB workloadNext (Workload, unsigned int);
+
+void workloadSeek (Workload, unsigned long long);
+
+WorkloadRecorder recorderOpen (const char *);
+
+int recorderWrite (WorkloadRecorder, PCB, unsigned int);
+
+void recorderClose (WorkloadRecorder);
+
+void recorderDetach (WorkloadRecorder);
+
+#endif
@@ -0,0 +1,313 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the defined functions declared in the workload_gen.h header file.
+	Arrivals are worked out in continuous time and land on the first tick at or after
+	that time, so several PCBs can arrive on the same tick during a burst.
+*/
+
+#include "workload_gen.h"
+#include "rng.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/*
+	Returns a sample from the exponential distribution with the given mean.
+*/
+double sampleExponential (double mean) {
+	return -mean * log(rngArrivalUniform());
+}
+
+
+/*
+	Returns a sample from the standard normal distribution (Box-Muller).
+*/
+double sampleNormal () {
+	double u1 = rngArrivalUniform();
+	double u2 = rngArrivalUniform();
+	return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+
+/*
+	Sets the generator to Poisson arrivals of uniform jobs, the same job sizes
+	makePCBList has always made.
+*/
+void generatorInit (Generator gen) {
+	memset(gen, 0, sizeof(Generator_s));
+	gen->arrival = ARRIVAL_POISSON;
+	gen->rate = GEN_DEFAULT_RATE;
+	gen->burst_rate = GEN_DEFAULT_BURST_RATE;
+	gen->dwell[0] = GEN_DEFAULT_CALM_DWELL;
+	gen->dwell[1] = GEN_DEFAULT_BURST_DWELL;
+	gen->size = SIZE_UNIFORM;
+	gen->pareto_alpha = GEN_DEFAULT_PARETO_ALPHA;
+	gen->size_min = SMALLEST_PC_POSSIBLE;
+	gen->lognormal_mu = GEN_DEFAULT_LOGNORMAL_MU;
+	gen->lognormal_sigma = GEN_DEFAULT_LOGNORMAL_SIGMA;
+	gen->io_density = GEN_DEFAULT_IO_DENSITY;
+}
+
+
+/*
+	Sets one generator setting by name. Returns 1 if the name and value are valid,
+	0 otherwise.
+
+	arrival     poisson or mmpp
+	rate        mean arrivals per tick (the calm rate for mmpp)
+	burst_rate  mean arrivals per tick while an mmpp burst lasts
+	calm_dwell  mean ticks between mmpp bursts
+	burst_dwell mean ticks an mmpp burst lasts
+	size        uniform, pareto or lognormal
+	alpha       Pareto shape, smaller is heavier tailed
+	min         smallest job size
+	mu, sigma   lognormal parameters of the log of the job size
+	io          expected I/O traps per 1000 instructions
+
+	Whether the rates add up to any arrivals at all is left to generatorCheck,
+	since they may be set in any order.
+*/
+int generatorSet (Generator gen, const char * key, const char * value) {
+	char * end;
+	double number = strtod(value, &end);
+	if (strcmp(key, "arrival") == 0) {
+		if (strcmp(value, "poisson") == 0) {
+			gen->arrival = ARRIVAL_POISSON;
+		} else if (strcmp(value, "mmpp") == 0) {
+			gen->arrival = ARRIVAL_MMPP;
+		} else {
+			return 0;
+		}
+	} else if (strcmp(key, "size") == 0) {
+		if (strcmp(value, "uniform") == 0) {
+			gen->size = SIZE_UNIFORM;
+		} else if (strcmp(value, "pareto") == 0) {
+			gen->size = SIZE_PARETO;
+		} else if (strcmp(value, "lognormal") == 0) {
+			gen->size = SIZE_LOGNORMAL;
+		} else {
+			return 0;
+		}
+	} else if (end == value || *end != '\0' || !isfinite(number)) {
+		return 0; // every other setting is a number
+	} else if (strcmp(key, "rate") == 0 && number >= 0) {
+		gen->rate = number;
+	} else if (strcmp(key, "burst_rate") == 0 && number >= 0) {
+		gen->burst_rate = number;
+	} else if (strcmp(key, "calm_dwell") == 0 && number > 0) {
+		gen->dwell[0] = number;
+	} else if (strcmp(key, "burst_dwell") == 0 && number > 0) {
+		gen->dwell[1] = number;
+	} else if (strcmp(key, "alpha") == 0 && number > 0) {
+		gen->pareto_alpha = number;
+	} else if (strcmp(key, "min") == 0 && number >= 1) {
+		gen->size_min = (unsigned int) number;
+	} else if (strcmp(key, "mu") == 0) {
+		gen->lognormal_mu = number;
+	} else if (strcmp(key, "sigma") == 0 && number >= 0) {
+		gen->lognormal_sigma = number;
+	} else if (strcmp(key, "io") == 0 && number >= 0) {
+		gen->io_density = number;
+	} else {
+		return 0;
+	}
+	return 1;
+}
+
+
+/*
+	Applies a comma separated list of key=value settings, such as
+	"arrival=mmpp,size=pareto,alpha=1.2". Returns 1 if every setting was valid,
+	0 otherwise.
+*/
+int generatorParse (Generator gen, const char * spec) {
+	char buffer[512];
+	char * setting, * value, * rest;
+	if (strlen(spec) >= sizeof(buffer)) {
+		return 0;
+	}
+	strcpy(buffer, spec);
+	for (setting = strtok_r(buffer, ",", &rest); setting != NULL; setting = strtok_r(NULL, ",", &rest)) {
+		value = strchr(setting, '=');
+		if (value == NULL) {
+			return 0;
+		}
+		*value++ = '\0';
+		if (!generatorSet(gen, setting, value)) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+
+/*
+	Writes every setting of the generator to out as the comma separated list
+	generatorParse reads, in at most size bytes.
+*/
+void generatorFormat (Generator gen, char * out, size_t size) {
+	const char * sizes[] = {"uniform", "pareto", "lognormal"};
+	snprintf(out, size, "arrival=%s,rate=%.15g,burst_rate=%.15g,calm_dwell=%.15g,burst_dwell=%.15g,"
+		"size=%s,alpha=%.15g,min=%u,mu=%.15g,sigma=%.15g,io=%.15g",
+		gen->arrival == ARRIVAL_MMPP ? "mmpp" : "poisson", gen->rate, gen->burst_rate, gen->dwell[0],
+		gen->dwell[1], sizes[gen->size], gen->pareto_alpha, gen->size_min, gen->lognormal_mu,
+		gen->lognormal_sigma, gen->io_density);
+}
+
+
+/*
+	Returns 1 if the generator will ever make an arrival, or prints why not and
+	returns 0.
+*/
+int generatorCheck (Generator gen) {
+	if (gen->arrival == ARRIVAL_POISSON && gen->rate <= 0) {
+		fprintf(stderr, "Poisson arrivals need a rate above 0\r\n");
+		return 0;
+	}
+	if (gen->arrival == ARRIVAL_MMPP && gen->rate + gen->burst_rate <= 0) {
+		fprintf(stderr, "MMPP arrivals need a rate or burst_rate above 0\r\n");
+		return 0;
+	}
+	return 1;
+}
+
+
+/*
+	Works out the time of the arrival after the current one. For MMPP the rate
+	depends on the state, and the state may flip any number of times before the
+	next arrival; the exponential is memoryless, so the wait simply restarts at
+	each flip. With no rate in either state there is never another arrival.
+*/
+void advanceArrival (Generator gen) {
+	double now = gen->next_time;
+	double rate, wait;
+	if (gen->rate <= 0 && (gen->arrival != ARRIVAL_MMPP || gen->burst_rate <= 0)) {
+		gen->next_time = INFINITY;
+		return;
+	}
+	for (;;) {
+		rate = (gen->arrival == ARRIVAL_MMPP && gen->mmpp_state) ? gen->burst_rate : gen->rate;
+		wait = rate > 0 ? sampleExponential(1.0 / rate) : INFINITY;
+		if (gen->arrival != ARRIVAL_MMPP || now + wait < gen->state_end) {
+			gen->next_time = now + wait;
+			return;
+		}
+		now = gen->state_end;
+		gen->mmpp_state = !gen->mmpp_state;
+		gen->state_end = now + sampleExponential(gen->dwell[gen->mmpp_state]);
+	}
+}
+
+
+/*
+	Starts the generator at the given tick and draws the first arrival.
+*/
+void generatorStart (Generator gen, unsigned int tick) {
+	gen->mmpp_state = 0;
+	gen->state_end = tick + sampleExponential(gen->dwell[0]);
+	gen->next_time = tick;
+	advanceArrival(gen);
+}
+
+
+/*
+	Returns the tick of the next arrival, or -1 if there will never be one.
+*/
+unsigned int generatorNextArrival (Generator gen) {
+	if (!(gen->next_time < 4294967295.0)) {
+		return -1;
+	}
+	return (unsigned int) ceil(gen->next_time);
+}
+
+
+/*
+	Draws a job size (max_pc) from the size distribution, kept between size_min
+	and GEN_MAX_PC_CAP.
+*/
+unsigned int generatorJobSize (Generator gen) {
+	double size;
+	if (gen->size == SIZE_PARETO) {
+		size = gen->size_min / pow(rngArrivalUniform(), 1.0 / gen->pareto_alpha);
+	} else if (gen->size == SIZE_LOGNORMAL) {
+		size = exp(gen->lognormal_mu + gen->lognormal_sigma * sampleNormal());
+	} else {
+		size = makeMaxPC();
+	}
+	if (size < gen->size_min) {
+		size = gen->size_min;
+	}
+	if (size > GEN_MAX_PC_CAP) {
+		size = GEN_MAX_PC_CAP;
+	}
+	return (unsigned int) size;
+}
+
+
+/*
+	Replaces the PCB's I/O traps with io_density traps per 1000 instructions on
+	average, up to the 2 * TRAP_COUNT slots a PCB has. Traps alternate between the
+	two devices and unused slots are -1, which the PC never reaches.
+*/
+void generatorPlaceTraps (Generator gen, PCB pcb) {
+	double expected = pcb->max_pc * gen->io_density / 1000.0;
+	unsigned int count = (unsigned int) expected;
+	unsigned int trap;
+	int duplicate;
+	if (rngArrivalUniform() < expected - count) {
+		count++;
+	}
+	if (count > 2 * TRAP_COUNT) {
+		count = 2 * TRAP_COUNT;
+	}
+	if (count > pcb->max_pc - 1) {
+		count = pcb->max_pc - 1;
+	}
+	for (int i = 0; i < TRAP_COUNT; i++) {
+		pcb->io_1_traps[i] = -1;
+		pcb->io_2_traps[i] = -1;
+	}
+	for (unsigned int i = 0; i < count; i++) {
+		do {
+			trap = 1 + rngArrivalRange(pcb->max_pc - 1);
+			duplicate = 0;
+			for (int j = 0; j < TRAP_COUNT; j++) {
+				if (pcb->io_1_traps[j] == trap || pcb->io_2_traps[j] == trap) {
+					duplicate = 1;
+				}
+			}
+		} while (duplicate);
+		if (i % 2 == 0) {
+			pcb->io_1_traps[i / 2] = trap;
+		} else {
+			pcb->io_2_traps[i / 2] = trap;
+		}
+	}
+}
+
+
+/*
+	If the next arrival is due at or before the given tick, makes its PCB, draws
+	the arrival after it and returns the PCB. Returns NULL if nothing is due yet.
+	A generated PCB runs through its max_pc once and terminates, so max_pc is its
+	whole service time.
+*/
+PCB generatorNext (Generator gen, unsigned int tick) {
+	PCB pcb;
+	if (generatorNextArrival(gen) > tick) {
+		return NULL;
+	}
+	pcb = PCB_create_blank(); // its size and traps are drawn here instead
+	if (pcb == NULL) {
+		return NULL;
+	}
+	pcb->max_pc = generatorJobSize(gen);
+	pcb->terminate = 1;
+	generatorPlaceTraps(gen, pcb);
+	advanceArrival(gen);
+	return pcb;
+}
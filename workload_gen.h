@@ -0,0 +1,85 @@
+/*
+	10/19/2026
+	Author: agent
+
+	This file holds the definitions of structs and declarations of functions for the
+	workload_gen.c file. A generator makes arrivals spread across ticks, with
+	interarrival times, job sizes and I/O trap density drawn from configurable
+	distributions.
+*/
+
+#ifndef WORKLOAD_GEN_H
+#define WORKLOAD_GEN_H
+
+//includes
+#include "pcb.h"
+#include <stddef.h>
+
+
+//defines
+#define GEN_DEFAULT_RATE 0.002
+#define GEN_DEFAULT_BURST_RATE 0.02
+#define GEN_DEFAULT_CALM_DWELL 20000.0
+#define GEN_DEFAULT_BURST_DWELL 2000.0
+#define GEN_DEFAULT_PARETO_ALPHA 1.5
+#define GEN_DEFAULT_LOGNORMAL_MU 5.5
+#define GEN_DEFAULT_LOGNORMAL_SIGMA 1.0
+#define GEN_DEFAULT_IO_DENSITY 8.0
+#define GEN_MAX_PC_CAP 10000000
+
+
+//enums
+enum arrival_kind {
+	ARRIVAL_POISSON,
+	ARRIVAL_MMPP
+};
+
+enum size_kind {
+	SIZE_UNIFORM,
+	SIZE_PARETO,
+	SIZE_LOGNORMAL
+};
+
+
+//structs
+typedef struct generator {
+	enum arrival_kind arrival;
+	double rate; // mean arrivals per tick, or the calm state's rate for MMPP
+	double burst_rate; // MMPP burst state's mean arrivals per tick
+	double dwell[2]; // MMPP mean ticks spent in the calm and burst states
+	enum size_kind size;
+	double pareto_alpha;
+	unsigned int size_min; // smallest max_pc for Pareto, and the floor for every kind
+	double lognormal_mu;
+	double lognormal_sigma;
+	double io_density; // expected I/O traps per 1000 instructions
+	int mmpp_state; // 0 calm, 1 burst
+	double state_end; // time the current MMPP state ends
+	double next_time; // time of the next arrival
+} Generator_s;
+
+typedef Generator_s * Generator;
+
+
+//declarations
+void generatorInit (Generator);
+
+int generatorSet (Generator, const char *, const char *);
+
+int generatorParse (Generator, const char *);
+
+int generatorCheck (Generator);
+
+void generatorFormat (Generator, char *, size_t);
+
+void generatorStart (Generator, unsigned int);
+
+unsigned int generatorNextArrival (Generator);
+
+PCB generatorNext (Generator, unsigned int);
+
+unsigned int generatorJobSize (Generator);
+
+void generatorPlaceTraps (Generator, PCB);
+
+#endif